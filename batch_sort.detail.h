@@ -0,0 +1,122 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include <cstdint>
+#include <type_traits>
+#include <utility>      // pair, swap
+#include <vector>
+
+namespace cdmh {
+
+namespace detail {
+
+// segments of up to this many elements are sorted with a sorting network
+size_t const batch_sort_network_max = 64;
+
+// number of segments of the same size that are sorted together, each comparator of
+// the network being applied to all of them in turn to give independent instructions
+size_t const batch_sort_interleave = 4;
+
+using sorting_network = std::vector<std::pair<std::uint8_t, std::uint8_t>>;
+
+// Batcher's odd-even merge sort network for `size` elements. the network for the next
+// power of two is generated and comparators that reach beyond `size` are dropped,
+// which is equivalent to padding the input with elements greater than all others
+inline sorting_network make_sorting_network(size_t size)
+{
+    size_t padded = 1;
+    while (padded < size)
+        padded <<= 1;
+
+    sorting_network network;
+    for (size_t p=1; p<padded; p<<=1)
+    {
+        for (size_t k=p; k>=1; k>>=1)
+        {
+            for (size_t j=k%p; j+k<padded; j+=2*k)
+            {
+                for (size_t i=0; i<std::min(k, padded-j-k); ++i)
+                {
+                    if ((i+j) / (2*p) == (i+j+k) / (2*p)  &&  i+j+k < size)
+                        network.push_back(std::make_pair(std::uint8_t(i+j), std::uint8_t(i+j+k)));
+                }
+            }
+        }
+    }
+    return network;
+}
+
+// networks for each segment size, built once on first use
+inline std::vector<sorting_network> const &sorting_networks()
+{
+    static std::vector<sorting_network> const networks = []() {
+        std::vector<sorting_network> networks;
+        for (size_t size=0; size<=batch_sort_network_max; ++size)
+            networks.push_back(make_sorting_network(size));
+        return networks;
+    }();
+    return networks;
+}
+
+// scalars are exchanged without a branch, so the compiler can use conditional moves
+template<typename T, typename Pred>
+inline void compare_exchange(T &first, T &second, Pred &pred, std::true_type)
+{
+    T const a = first;
+    T const b = second;
+    bool const swap = pred(b, a);
+    first  = swap? b : a;
+    second = swap? a : b;
+}
+
+template<typename T, typename Pred>
+inline void compare_exchange(T &first, T &second, Pred &pred, std::false_type)
+{
+    if (pred(second, first))
+    {
+        using std::swap;
+        swap(first, second);
+    }
+}
+
+template<typename T, typename Pred>
+inline void compare_exchange(T &first, T &second, Pred &pred)
+{
+    detail::compare_exchange(first, second, pred, std::is_scalar<T>());
+}
+
+// apply a network to `count` segments that each start at the given iterators
+template<typename It, typename Pred>
+inline void apply_sorting_network(sorting_network const &network, It const *segments, size_t count, Pred &pred)
+{
+    for (auto const &comparator : network)
+    {
+        for (size_t loop=0; loop<count; ++loop)
+            detail::compare_exchange(segments[loop][comparator.first], segments[loop][comparator.second], pred);
+    }
+}
+
+}   // namespace detail
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,116 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "batch_sort.detail.h"
+#include "introsort.h"
+#include "scratch.h"
+#include <thread>
+
+namespace cdmh {
+
+// Batch Sort
+//     Worst case performance       O(n log^2 s) for segments of up to 64 elements
+//     Worst case space complexity  O(k) auxiliary for k segments
+// http://en.wikipedia.org/wiki/Batcher_odd%E2%80%93even_mergesort
+//
+// sorts many independent segments of a range in one call. the segments are given as
+// k+1 offsets into the range, segment i being [values+offsets[i], values+offsets[i+1]).
+// segments are grouped by size, and segments of up to 64 elements are sorted with a
+// Batcher odd-even merge network for their size, several segments at a time with each
+// comparator applied to all of them in turn. the compare-exchange of scalar elements
+// is branch free. larger segments are sorted with introsort. the groups can be shared
+// between a number of threads. the order of the segments is allocated with the
+// allocator given. requires random access iterators
+
+namespace detail {
+
+// sort the segments listed in [first, last), all of which are `size` elements long
+template<typename It, typename OffsetIt, typename Pred>
+inline void sort_segments(It values, OffsetIt offsets, size_t const *first, size_t const *last, size_t size, Pred pred)
+{
+    if (size > batch_sort_network_max)
+    {
+        for (; first!=last; ++first)
+            cdmh::introsort(values + offsets[*first], values + offsets[*first + 1], pred);
+        return;
+    }
+
+    auto const &network = sorting_networks()[size];
+    It segments[batch_sort_interleave];
+    while (first != last)
+    {
+        size_t count = 0;
+        for (; count < batch_sort_interleave  &&  first != last; ++count, ++first)
+            segments[count] = values + offsets[*first];
+        detail::apply_sorting_network(network, segments, count, pred);
+    }
+}
+
+}   // namespace detail
+
+template<typename It, typename OffsetIt, typename Pred=std::less<typename std::iterator_traits<It>::value_type>, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void batch_sort(It values, OffsetIt offsets_begin, OffsetIt offsets_end, Pred pred=Pred(), unsigned threads=1, Alloc const &alloc=Alloc())
+{
+    auto const segments = std::distance(offsets_begin, offsets_end);
+    if (segments < 2)
+        return;
+
+    // order the segments by size with a counting sort, all large segments sharing a class
+    size_t const classes = detail::batch_sort_network_max + 2;
+    auto const size_class = [offsets_begin](size_t segment) {
+        return std::min<size_t>(offsets_begin[segment + 1] - offsets_begin[segment], detail::batch_sort_network_max + 1);
+    };
+    detail::scratch_vector<size_t, Alloc> starts(classes + 1, 0, alloc);
+    for (size_t segment=0; segment<size_t(segments-1); ++segment)
+        ++starts[size_class(segment) + 1];
+    for (size_t loop=1; loop<=classes; ++loop)
+        starts[loop] += starts[loop - 1];
+
+    detail::scratch_vector<size_t, Alloc> order(segments - 1, 0, alloc);
+    {
+        auto next = starts;
+        for (size_t segment=0; segment<order.size(); ++segment)
+            order[next[size_class(segment)]++] = segment;
+    }
+
+    // each thread sorts an equal share of the segments of every size
+    auto const sort_share = [&](size_t share, size_t shares) {
+        for (size_t size=2; size<classes; ++size)
+        {
+            auto const count = starts[size + 1] - starts[size];
+            auto const first = order.data() + starts[size] + count * share / shares;
+            auto const last  = order.data() + starts[size] + count * (share + 1) / shares;
+            detail::sort_segments(values, offsets_begin, first, last, size, pred);
+        }
+    };
+
+    detail::scratch_vector<std::thread, Alloc> workers(alloc);
+    for (size_t share=1; share<threads; ++share)
+        workers.emplace_back(sort_share, share, threads);
+    sort_share(0, std::max(threads, 1u));
+    for (auto &worker : workers)
+        worker.join();
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
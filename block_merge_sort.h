@@ -0,0 +1,759 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "insertion_sort.h"
+#include <algorithm>    // lower_bound, upper_bound, rotate, swap_ranges
+#include <cmath>        // sqrt
+
+namespace cdmh {
+
+// Block Merge Sort (WikiSort)
+//     Worst case performance       O(n log n)
+//     Best case performance        O(n)
+//     Average case performance     O(n log n)
+//     Worst case space complexity  O(1) auxiliary
+// http://en.wikipedia.org/wiki/Block_sort
+//
+// a stable bottom-up merge sort that needs no buffer. groups of 16 to 31 elements are
+// insertion sorted, and at each level of merges two internal buffers of about sqrt(A)
+// distinct values are pulled out of the data: the first tags the blocks of sqrt(A)
+// elements that A is divided into, so they can be rolled through B and dropped in
+// order, and the second is the workspace for merging each dropped A block with the B
+// values that follow it, by swapping. the buffers are redistributed at the end of
+// each level, and data with too few distinct values for the second buffer is merged
+// by binary searches and rotations instead. a small cache of elements supplied by
+// the caller is used, if given, for merges of blocks that fit in it and for
+// rotations. requires random access iterators
+
+namespace detail {
+
+// groups of this many to twice as many elements are insertion sorted before merging
+size_t const block_merge_min_level = 16;
+
+template<typename It, typename Pred>
+class block_merger
+{
+  public:
+    using value_type = typename std::iterator_traits<It>::value_type;
+
+    block_merger(It array, size_t size, Pred &pred, value_type *cache, size_t cache_size)
+      : array_(array),
+        size_(size),
+        pred_(pred),
+        cache_(cache),
+        cache_size_(cache ? cache_size : 0)
+    {
+    }
+
+    void sort();
+
+  private:
+    struct range
+    {
+        range(size_t start=0, size_t end=0) : start(start), end(end)
+        {
+        }
+
+        size_t length() const
+        {
+            return end - start;
+        }
+
+        size_t start;
+        size_t end;
+    };
+
+    // where the values of an internal buffer are pulled from and to, and how many
+    struct pull
+    {
+        pull() : from(0), to(0), count(0)
+        {
+        }
+
+        size_t from;
+        size_t to;
+        size_t count;
+        range  span;    // the A and B subarrays the values are pulled from
+    };
+
+    // divides the range into 2^k subarrays whose sizes differ by at most one, at each
+    // level of the merges, using fixed point arithmetic
+    class level_iterator
+    {
+      public:
+        level_iterator(size_t size, size_t min_level) : size_(size)
+        {
+            size_t power_of_two = 1;
+            while (power_of_two * 2 <= size)
+                power_of_two *= 2;
+            denominator_    = power_of_two / min_level;
+            numerator_step_ = size % denominator_;
+            decimal_step_   = size / denominator_;
+            begin();
+        }
+
+        void begin()
+        {
+            numerator_ = decimal_ = 0;
+        }
+
+        range next()
+        {
+            size_t const start = decimal_;
+            decimal_   += decimal_step_;
+            numerator_ += numerator_step_;
+            if (numerator_ >= denominator_)
+            {
+                numerator_ -= denominator_;
+                ++decimal_;
+            }
+            return range(start, decimal_);
+        }
+
+        bool finished() const
+        {
+            return decimal_ >= size_;
+        }
+
+        bool next_level()
+        {
+            decimal_step_   += decimal_step_;
+            numerator_step_ += numerator_step_;
+            if (numerator_step_ >= denominator_)
+            {
+                numerator_step_ -= denominator_;
+                ++decimal_step_;
+            }
+            return decimal_step_ < size_;
+        }
+
+        size_t length() const
+        {
+            return decimal_step_;
+        }
+
+      private:
+        size_t size_;
+        size_t numerator_;
+        size_t decimal_;
+        size_t denominator_;
+        size_t decimal_step_;
+        size_t numerator_step_;
+    };
+
+    value_type &at(size_t index)
+    {
+        return array_[index];
+    }
+
+    bool less(size_t first, size_t second)
+    {
+        return pred_(array_[first], array_[second]);
+    }
+
+    size_t binary_first(value_type const &value, range r)
+    {
+        return std::lower_bound(array_ + r.start, array_ + r.end, value, pred_) - array_;
+    }
+
+    size_t binary_last(value_type const &value, range r)
+    {
+        return std::upper_bound(array_ + r.start, array_ + r.end, value, pred_) - array_;
+    }
+
+    // binary searches preceded by a search in steps of length/unique, for a range
+    // expected to hold about `unique` distinct values
+    size_t find_first_forward(value_type const &value, range r, size_t unique)
+    {
+        if (r.length() == 0)
+            return r.start;
+        size_t const skip = std::max<size_t>(r.length() / unique, 1);
+        size_t index;
+        for (index=r.start+skip; pred_(at(index - 1), value); index+=skip)
+        {
+            if (index >= r.end - skip)
+                return binary_first(value, range(index, r.end));
+        }
+        return binary_first(value, range(index - skip, index));
+    }
+
+    size_t find_last_forward(value_type const &value, range r, size_t unique)
+    {
+        if (r.length() == 0)
+            return r.start;
+        size_t const skip = std::max<size_t>(r.length() / unique, 1);
+        size_t index;
+        for (index=r.start+skip; !pred_(value, at(index - 1)); index+=skip)
+        {
+            if (index >= r.end - skip)
+                return binary_last(value, range(index, r.end));
+        }
+        return binary_last(value, range(index - skip, index));
+    }
+
+    size_t find_first_backward(value_type const &value, range r, size_t unique)
+    {
+        if (r.length() == 0)
+            return r.start;
+        size_t const skip = std::max<size_t>(r.length() / unique, 1);
+        size_t index;
+        for (index=r.end-skip; index>r.start  &&  !pred_(at(index - 1), value); index-=skip)
+        {
+            if (index < r.start + skip)
+                return binary_first(value, range(r.start, index));
+        }
+        return binary_first(value, range(index, index + skip));
+    }
+
+    size_t find_last_backward(value_type const &value, range r, size_t unique)
+    {
+        if (r.length() == 0)
+            return r.start;
+        size_t const skip = std::max<size_t>(r.length() / unique, 1);
+        size_t index;
+        for (index=r.end-skip; index>r.start  &&  pred_(value, at(index - 1)); index-=skip)
+        {
+            if (index < r.start + skip)
+                return binary_last(value, range(r.start, index));
+        }
+        return binary_last(value, range(index, index + skip));
+    }
+
+    void block_swap(size_t first, size_t second, size_t count)
+    {
+        std::swap_ranges(array_ + first, array_ + first + count, array_ + second);
+    }
+
+    // rotate r left by amount, through the cache if the shorter side fits in it
+    void rotate(size_t amount, range r, bool use_cache=true)
+    {
+        if (amount == 0  ||  amount == r.length())
+            return;
+
+        size_t const split = r.start + amount;
+        size_t const left  = amount;
+        size_t const right = r.end - split;
+        if (use_cache  &&  left <= cache_size_  &&  left <= right)
+        {
+            std::move(array_ + r.start, array_ + split, cache_);
+            std::move(array_ + split, array_ + r.end, array_ + r.start);
+            std::move(cache_, cache_ + left, array_ + r.start + right);
+        }
+        else if (use_cache  &&  right <= cache_size_)
+        {
+            std::move(array_ + split, array_ + r.end, cache_);
+            std::move_backward(array_ + r.start, array_ + split, array_ + r.end);
+            std::move(cache_, cache_ + right, array_ + r.start);
+        }
+        else
+            std::rotate(array_ + r.start, array_ + split, array_ + r.end);
+    }
+
+    // merge A, whose values have been moved to the cache, with B into A and B
+    void merge_external(range a, range b)
+    {
+        value_type *a_index = cache_;
+        value_type *a_last  = cache_ + a.length();
+        size_t b_index = b.start;
+        size_t insert  = a.start;
+        if (b.length() > 0  &&  a.length() > 0)
+        {
+            for (;;)
+            {
+                if (!pred_(at(b_index), *a_index))
+                {
+                    at(insert++) = std::move(*a_index++);
+                    if (a_index == a_last)
+                        break;
+                }
+                else
+                {
+                    at(insert++) = std::move(at(b_index++));
+                    if (b_index == b.end)
+                        break;
+                }
+            }
+        }
+        std::move(a_index, a_last, array_ + insert);
+    }
+
+    // merge A, whose values have been swapped into the buffer, with B into A and B,
+    // swapping each value into place so the buffer keeps its values in another order
+    void merge_internal(range a, range b, range buffer)
+    {
+        size_t a_count = 0;
+        size_t b_count = 0;
+        size_t insert  = 0;
+        if (b.length() > 0  &&  a.length() > 0)
+        {
+            for (;;)
+            {
+                if (!less(b.start + b_count, buffer.start + a_count))
+                {
+                    std::swap(at(a.start + insert), at(buffer.start + a_count));
+                    ++a_count;
+                    ++insert;
+                    if (a_count >= a.length())
+                        break;
+                }
+                else
+                {
+                    std::swap(at(a.start + insert), at(b.start + b_count));
+                    ++b_count;
+                    ++insert;
+                    if (b_count >= b.length())
+                        break;
+                }
+            }
+        }
+        block_swap(buffer.start + a_count, a.start + insert, a.length() - a_count);
+    }
+
+    // merge without a buffer, by rotating the rest of A into place after the B values
+    // less than its first value
+    void merge_in_place(range a, range b)
+    {
+        if (a.length() == 0  ||  b.length() == 0)
+            return;
+
+        for (;;)
+        {
+            size_t const middle = binary_first(at(a.start), b);
+            size_t const amount = middle - a.end;
+            rotate(a.length(), range(a.start, middle));
+            if (b.end == middle)
+                break;
+
+            b.start = middle;
+            a = range(a.start + amount, b.start);
+            a.start = binary_last(at(a.start), a);
+            if (a.length() == 0)
+                break;
+        }
+    }
+
+    // merge the A block `last_a` with the B values that follow it
+    void merge_block(range last_a, range b, range buffer2)
+    {
+        if (last_a.length() <= cache_size_)
+            merge_external(last_a, b);
+        else if (buffer2.length() > 0)
+            merge_internal(last_a, b, buffer2);
+        else
+            merge_in_place(last_a, b);
+    }
+
+    void find_buffers(level_iterator &iterator, size_t block_size, size_t buffer_size, range &buffer1, range &buffer2, pull (&pulls)[2]);
+    void merge_level(level_iterator &iterator);
+
+    It          array_;
+    size_t      size_;
+    Pred       &pred_;
+    value_type *cache_;
+    size_t      cache_size_;
+};
+
+// find two internal buffers of buffer_size distinct values each, or the largest
+// single buffer there is, and record where their values are to be pulled from
+template<typename It, typename Pred>
+inline void block_merger<It, Pred>::find_buffers(level_iterator &iterator, size_t block_size, size_t buffer_size, range &buffer1, range &buffer2, pull (&pulls)[2])
+{
+    // the second buffer is not needed if every A block fits into the cache, and if
+    // the two can't fit into one A or B subarray, they are found separately
+    size_t find = buffer_size + buffer_size;
+    bool find_separately = false;
+    if (block_size <= cache_size_)
+        find = buffer_size;
+    else if (find > iterator.length())
+    {
+        find = buffer_size;
+        find_separately = true;
+    }
+
+    size_t pull_index = 0;
+    auto const record = [&](range a, range b, size_t count, size_t from, size_t to) {
+        pulls[pull_index].span  = range(a.start, b.end);
+        pulls[pull_index].count = count;
+        pulls[pull_index].from  = from;
+        pulls[pull_index].to    = to;
+    };
+
+    for (iterator.begin(); !iterator.finished(); )
+    {
+        range const a = iterator.next();
+        range const b = iterator.next();
+
+        // count the distinct values at the start of A, which would be pulled to its start
+        size_t last;
+        size_t count;
+        size_t index = 0;
+        for (last=a.start, count=1; count<find; last=index, ++count)
+        {
+            index = find_last_forward(at(last), range(last + 1, a.end), find - count);
+            if (index == a.end)
+                break;
+        }
+        index = last;
+
+        if (count >= buffer_size)
+        {
+            record(a, b, count, index, a.start);
+            pull_index = 1;
+            if (count == buffer_size + buffer_size)
+            {
+                // a single section holds the values of both buffers
+                buffer1 = range(a.start, a.start + buffer_size);
+                buffer2 = range(a.start + buffer_size, a.start + count);
+                break;
+            }
+            else if (find == buffer_size + buffer_size)
+            {
+                // the first buffer is found, but the second still has to be
+                buffer1 = range(a.start, a.start + count);
+                find = buffer_size;
+            }
+            else if (block_size <= cache_size_)
+            {
+                buffer1 = range(a.start, a.start + count);
+                break;
+            }
+            else if (find_separately)
+            {
+                buffer1 = range(a.start, a.start + count);
+                find_separately = false;
+            }
+            else
+            {
+                buffer2 = range(a.start, a.start + count);
+                break;
+            }
+        }
+        else if (pull_index == 0  &&  count > buffer1.length())
+        {
+            // keep track of the largest buffer found
+            buffer1 = range(a.start, a.start + count);
+            record(a, b, count, index, a.start);
+        }
+
+        // count the distinct values at the end of B, which would be pulled to its end
+        for (last=b.end-1, count=1; count<find; last=index-1, ++count)
+        {
+            index = find_first_backward(at(last), range(b.start, last), find - count);
+            if (index == b.start)
+                break;
+        }
+        index = last;
+
+        if (count >= buffer_size)
+        {
+            record(a, b, count, index, b.end);
+            pull_index = 1;
+            if (count == buffer_size + buffer_size)
+            {
+                buffer1 = range(b.end - count, b.end - buffer_size);
+                buffer2 = range(b.end - buffer_size, b.end);
+                break;
+            }
+            else if (find == buffer_size + buffer_size)
+            {
+                buffer1 = range(b.end - count, b.end);
+                find = buffer_size;
+            }
+            else if (block_size <= cache_size_)
+            {
+                buffer1 = range(b.end - count, b.end);
+                break;
+            }
+            else if (find_separately)
+            {
+                buffer1 = range(b.end - count, b.end);
+                find_separately = false;
+            }
+            else
+            {
+                // the first buffer's values, if pulled from this A, stop before these
+                if (pulls[0].span.start == a.start)
+                    pulls[0].span.end -= pulls[1].count;
+                buffer2 = range(b.end - count, b.end);
+                break;
+            }
+        }
+        else if (pull_index == 0  &&  count > buffer1.length())
+        {
+            buffer1 = range(b.end - count, b.end);
+            record(a, b, count, index, b.end);
+        }
+    }
+}
+
+// merge each pair of A and B subarrays of this level in place
+template<typename It, typename Pred>
+inline void block_merger<It, Pred>::merge_level(level_iterator &iterator)
+{
+    size_t block_size  = size_t(std::sqrt(double(iterator.length())));
+    size_t buffer_size = iterator.length() / block_size + 1;
+
+    range buffer1;
+    range buffer2;
+    pull  pulls[2];
+    find_buffers(iterator, block_size, buffer_size, buffer1, buffer2, pulls);
+
+    // pull the distinct values out to the start of A or the end of B, in order
+    for (auto &p : pulls)
+    {
+        size_t const length = p.count;
+        if (p.to < p.from)
+        {
+            size_t index = p.from;
+            for (size_t count=1; count<length; ++count)
+            {
+                index = find_first_backward(at(index - 1), range(p.to, p.from - (count - 1)), length - count);
+                range const r(index + 1, p.from + 1);
+                rotate(r.length() - count, r);
+                p.from = index + count;
+            }
+        }
+        else if (p.to > p.from)
+        {
+            size_t index = p.from + 1;
+            for (size_t count=1; count<length; ++count)
+            {
+                index = find_last_forward(at(index), range(index, p.to), length - count);
+                range const r(p.from, index - 1);
+                rotate(count, r);
+                p.from = index - 1 - count;
+            }
+        }
+    }
+
+    // there must be a value in the first buffer to tag each A block
+    buffer_size = buffer1.length();
+    block_size  = iterator.length() / buffer_size + 1;
+
+    for (iterator.begin(); !iterator.finished(); )
+    {
+        range a = iterator.next();
+        range b = iterator.next();
+
+        // leave out the parts of A or B holding the internal buffers
+        size_t const start = a.start;
+        bool empty = false;
+        for (auto const &p : pulls)
+        {
+            if (start != p.span.start)
+                continue;
+            if (p.from > p.to)
+                a.start += p.count;
+            else if (p.from < p.to)
+                b.end -= p.count;
+            empty = empty  ||  a.length() == 0  ||  b.length() == 0;
+        }
+        if (empty)
+            continue;
+
+        if (less(b.end - 1, a.start))
+        {
+            // the two ranges are in reverse order, so a rotation merges them
+            rotate(a.length(), range(a.start, b.end));
+        }
+        else if (less(a.end, a.end - 1))
+        {
+            // divide A into blocks, the first of them the uneven remainder, and swap
+            // the first value of each of the others with a value of the first buffer
+            range block_a(a.start, a.end);
+            range const first_a(a.start, a.start + block_a.length() % block_size);
+            for (size_t index_a=buffer1.start, index=first_a.end; index<block_a.end; ++index_a, index+=block_size)
+                std::swap(at(index_a), at(index));
+
+            // roll the A blocks through the B blocks, dropping the smallest A block behind
+            // in place when the next B block should follow it, and merging each A block
+            // dropped with the B values after it
+            range last_a = first_a;
+            range last_b;
+            range block_b(b.start, b.start + std::min(block_size, b.length()));
+            block_a.start += first_a.length();
+            size_t index_a = buffer1.start;
+
+            // the values of the block being merged are held in the cache or the second buffer
+            if (last_a.length() <= cache_size_)
+                std::move(array_ + last_a.start, array_ + last_a.end, cache_);
+            else if (buffer2.length() > 0)
+                block_swap(last_a.start, buffer2.start, last_a.length());
+
+            while (block_a.length() > 0)
+            {
+                if ((last_b.length() > 0  &&  !less(last_b.end - 1, index_a))  ||  block_b.length() == 0)
+                {
+                    // split the previous B block where the smallest A block belongs
+                    size_t const b_split     = binary_first(at(index_a), last_b);
+                    size_t const b_remaining = last_b.end - b_split;
+
+                    // the smallest A block is the one with the smallest tag
+                    size_t min_a = block_a.start;
+                    for (size_t find_a=min_a+block_size; find_a<block_a.end; find_a+=block_size)
+                    {
+                        if (less(find_a, min_a))
+                            min_a = find_a;
+                    }
+                    block_swap(block_a.start, min_a, block_size);
+
+                    // restore the first value of the A block, and merge the previous A block
+                    std::swap(at(block_a.start), at(index_a));
+                    ++index_a;
+                    merge_block(last_a, range(last_a.end, b_split), buffer2);
+
+                    if (buffer2.length() > 0  ||  block_size <= cache_size_)
+                    {
+                        // with the values of the A block held elsewhere, the rest of the
+                        // B block can be swapped into place rather than rotated
+                        if (block_size <= cache_size_)
+                            std::move(array_ + block_a.start, array_ + block_a.start + block_size, cache_);
+                        else
+                            block_swap(block_a.start, buffer2.start, block_size);
+                        block_swap(b_split, block_a.start + block_size - b_remaining, b_remaining);
+                    }
+                    else
+                        rotate(block_a.start - b_split, range(b_split, block_a.start + block_size));
+
+                    last_a = range(block_a.start - b_remaining, block_a.start - b_remaining + block_size);
+                    last_b = range(last_a.end, last_a.end + b_remaining);
+                    block_a.start += block_size;
+                }
+                else if (block_b.length() < block_size)
+                {
+                    // rotate the last, uneven, B block before the A blocks, without the
+                    // cache, which may hold the values of the previous A block
+                    rotate(block_b.start - block_a.start, range(block_a.start, block_b.end), false);
+                    last_b = range(block_a.start, block_a.start + block_b.length());
+                    block_a.start += block_b.length();
+                    block_a.end   += block_b.length();
+                    block_b.end    = block_b.start;
+                }
+                else
+                {
+                    // roll the first A block to the end by swapping it with the next B block
+                    block_swap(block_a.start, block_b.start, block_size);
+                    last_b = range(block_a.start, block_a.start + block_size);
+                    block_a.start += block_size;
+                    block_a.end   += block_size;
+                    block_b.start += block_size;
+                    block_b.end    = (block_b.end > b.end - block_size)? b.end : block_b.end + block_size;
+                }
+            }
+            merge_block(last_a, range(last_a.end, b.end), buffer2);
+        }
+    }
+
+    // sort the second buffer, whose values were reordered by the merges, and
+    // redistribute both buffers back into the subarrays they were pulled from
+    detail::insertion_sort(array_ + buffer2.start, array_ + buffer2.end, pred_);
+    for (auto const &p : pulls)
+    {
+        size_t unique = p.count * 2;
+        if (p.from > p.to)
+        {
+            range buffer(p.span.start, p.span.start + p.count);
+            while (buffer.length() > 0)
+            {
+                size_t const index  = find_first_forward(at(buffer.start), range(buffer.end, p.span.end), unique);
+                size_t const amount = index - buffer.end;
+                rotate(buffer.length(), range(buffer.start, index));
+                buffer.start += amount + 1;
+                buffer.end   += amount;
+                unique -= 2;
+            }
+        }
+        else if (p.from < p.to)
+        {
+            range buffer(p.span.end - p.count, p.span.end);
+            while (buffer.length() > 0)
+            {
+                size_t const index  = find_last_backward(at(buffer.end - 1), range(p.span.start, buffer.start), unique);
+                size_t const amount = buffer.start - index;
+                rotate(amount, range(index, buffer.end));
+                buffer.start -= amount;
+                buffer.end   -= amount + 1;
+                unique -= 2;
+            }
+        }
+    }
+}
+
+template<typename It, typename Pred>
+inline void block_merger<It, Pred>::sort()
+{
+    if (size_ < 2 * block_merge_min_level)
+    {
+        detail::insertion_sort(array_, array_ + size_, pred_);
+        return;
+    }
+
+    level_iterator iterator(size_, block_merge_min_level);
+    while (!iterator.finished())
+    {
+        range const group = iterator.next();
+        detail::insertion_sort(array_ + group.start, array_ + group.end, pred_);
+    }
+
+    do
+    {
+        if (iterator.length() < cache_size_)
+        {
+            // A fits into the cache, so each merge moves A there and merges it with B
+            for (iterator.begin(); !iterator.finished(); )
+            {
+                range const a = iterator.next();
+                range const b = iterator.next();
+                if (less(b.end - 1, a.start))
+                    rotate(a.length(), range(a.start, b.end));
+                else if (less(b.start, a.end - 1))
+                {
+                    std::move(array_ + a.start, array_ + a.end, cache_);
+                    merge_external(a, b);
+                }
+            }
+        }
+        else
+            merge_level(iterator);
+    } while (iterator.next_level());
+}
+
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline void block_merge_sort(It begin, It end, Pred pred=Pred())
+{
+    auto const range = detail::kernel_range(begin, end);
+    detail::block_merger<decltype(range.first), Pred>(range.first, std::distance(begin, end), pred, nullptr, 0).sort();
+}
+
+// block merge sort using a cache of `cache_size` elements supplied by the caller
+template<typename It, typename Pred>
+inline void block_merge_sort(It begin, It end, Pred pred, typename std::iterator_traits<It>::value_type *cache, size_t cache_size)
+{
+    auto const range = detail::kernel_range(begin, end);
+    detail::block_merger<decltype(range.first), Pred>(range.first, std::distance(begin, end), pred, cache, cache_size).sort();
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -1,6 +1,8 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "sort.h"
 
 namespace cdmh {
@@ -12,8 +14,10 @@ namespace cdmh {
 //     Wost case space complexity   O(1)
 // http://en.wikipedia.org/wiki/Bubble_sort
 
-template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void bubble_sort(It begin, It end, Pred pred=Pred())
+namespace detail {
+
+template<typename It, typename Pred>
+inline void bubble_sort(It begin, It end, Pred pred)
 {
     if (std::distance(begin, end) <= 1)
         return;
@@ -36,6 +40,15 @@ inline void bubble_sort(It begin, It end, Pred pred=Pred())
     }
 }
 
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline void bubble_sort(It begin, It end, Pred pred=Pred())
+{
+    auto const range = detail::kernel_range(begin, end);
+    detail::bubble_sort(range.first, range.second, pred);
+}
+
 }   // namespace cdmh
 
 // Permission is hereby granted, free of charge, to any person obtaining a copy
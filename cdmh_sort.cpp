@@ -0,0 +1,525 @@
+// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+// sort lines of text, in the manner of `LC_ALL=C sort`
+//
+//   cdmh_sort [-n] [-r] [-t char] [-k field[,field]] [--parallel=threads] [file...]
+//
+// lines are compared as unsigned bytes. as with sort, lines with equal keys are
+// ordered by comparing the whole line. input is read from the files, or from the
+// standard input if there are none, and the sorted lines are written to the
+// standard output. a single regular file is memory mapped rather than read, and
+// the lines themselves are never copied; an array of line descriptors is sorted
+// in parallel and the lines are written from the input in sorted order
+
+#include "parallel_sort.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+struct options
+{
+    options() : numeric(false), reverse(false), separator(0), first_field(0), last_field(0), threads(std::thread::hardware_concurrency())
+    {
+    }
+
+    bool     numeric;
+    bool     reverse;
+    char     separator;     // field separator, or 0 for blank-separated fields
+    size_t   first_field;   // 1-based key fields, or 0 for the whole line
+    size_t   last_field;    // 0 for the end of the line
+    unsigned threads;
+};
+
+// a line of the input, and the leading bytes (or numeric value) of its key in a
+// form that can be compared as an integer, so most comparisons never touch the text.
+// lines are limited to 4 GiB to keep the descriptors small
+struct line
+{
+    std::uint64_t prefix;
+    size_t        offset;
+    std::uint32_t length;
+    std::uint32_t key_offset;
+    std::uint32_t key_length;
+};
+
+class input
+{
+  public:
+    explicit input(std::vector<std::string> const &paths)
+      : data_(nullptr),
+        size_(0),
+        mapped_(false)
+    {
+        if (paths.size() == 1  &&  map(paths[0]))
+            return;
+
+        if (paths.empty())
+            read(STDIN_FILENO, "standard input");
+        for (auto const &path : paths)
+        {
+            int const fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1)
+                throw std::system_error(errno, std::system_category(), path);
+            read(fd, path);
+            ::close(fd);
+        }
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    ~input()
+    {
+        if (mapped_)
+            ::munmap(const_cast<char *>(data_), size_);
+    }
+
+    char const *data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+  private:
+    input(input const &);
+    input &operator=(input const &);
+
+    bool map(std::string const &path)
+    {
+        int const fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw std::system_error(errno, std::system_category(), path);
+
+        struct stat st;
+        if (::fstat(fd, &st) == -1  ||  !S_ISREG(st.st_mode)  ||  st.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+        void *data = ::mmap(nullptr, st.st_size, PROT_READ, flags, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return false;
+
+        data_   = static_cast<char const *>(data);
+        size_   = st.st_size;
+        mapped_ = true;
+        return true;
+    }
+
+    void read(int fd, std::string const &name)
+    {
+        size_t const block = 1 << 20;
+        for (;;)
+        {
+            auto const size = buffer_.size();
+            buffer_.resize(size + block);
+            auto const count = ::read(fd, &buffer_[size], block);
+            buffer_.resize(size + std::max<ssize_t>(count, 0));
+            if (count == 0)
+                break;
+            else if (count == -1  &&  errno != EINTR)
+                throw std::system_error(errno, std::system_category(), name);
+        }
+
+        // as with sort, the last line of each input ends with a newline, so it is not
+        // joined to the first line of the next
+        if (!buffer_.empty()  &&  buffer_.back() != '\n')
+            buffer_.push_back('\n');
+    }
+
+    std::vector<char> buffer_;
+    char const       *data_;
+    size_t            size_;
+    bool              mapped_;
+};
+
+bool is_blank(char ch)
+{
+    return ch == ' '  ||  ch == '\t';
+}
+
+// position of the start of a 1-based field, or of the end of the line if there are fewer fields
+char const *field(char const *begin, char const *end, size_t number, char separator)
+{
+    auto it = begin;
+    for (size_t loop=1; loop<number  &&  it!=end; ++loop)
+    {
+        if (separator)
+        {
+            it = static_cast<char const *>(std::memchr(it, separator, end - it));
+            it = it? it + 1 : end;
+        }
+        else
+        {
+            // a field is a run of blanks followed by a run of non-blanks
+            while (it != end  &&  is_blank(*it))
+                ++it;
+            while (it != end  &&  !is_blank(*it))
+                ++it;
+        }
+    }
+    return it;
+}
+
+// end of the 1-based field that starts at `begin`
+char const *field_end(char const *begin, char const *end, char separator)
+{
+    if (separator)
+    {
+        auto const it = static_cast<char const *>(std::memchr(begin, separator, end - begin));
+        return it? it : end;
+    }
+
+    auto it = begin;
+    while (it != end  &&  is_blank(*it))
+        ++it;
+    while (it != end  &&  !is_blank(*it))
+        ++it;
+    return it;
+}
+
+// order preserving map of the leading number of a key to an unsigned integer.
+// as with sort, a number is an optional minus sign, digits and a decimal point
+std::uint64_t numeric_prefix(char const *begin, char const *end)
+{
+    while (begin != end  &&  is_blank(*begin))
+        ++begin;
+
+    std::string text;
+    auto it = begin;
+    if (it != end  &&  *it == '-')
+        text.push_back(*it++);
+    for (bool point=false; it != end  &&  ((*it >= '0'  &&  *it <= '9')  ||  (*it == '.'  &&  !point)); ++it)
+    {
+        point = point  ||  *it == '.';
+        text.push_back(*it);
+    }
+
+    double value = std::strtod(text.c_str(), nullptr);
+    if (value == 0.0)
+        value = 0.0;    // -0 sorts as 0
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & (std::uint64_t(1) << 63))? ~bits : bits | (std::uint64_t(1) << 63);
+}
+
+bool is_digit(char ch)
+{
+    return ch >= '0'  &&  ch <= '9';
+}
+
+// the leading number of a key, as read by numeric_prefix, without leading zeros in
+// its integer part or trailing zeros in its fraction
+struct number
+{
+    bool        negative;
+    char const *integer;
+    size_t      integer_length;
+    char const *fraction;
+    size_t      fraction_length;
+};
+
+number parse_number(char const *begin, char const *end)
+{
+    while (begin != end  &&  is_blank(*begin))
+        ++begin;
+
+    number n;
+    n.negative = begin != end  &&  *begin == '-';
+    if (n.negative)
+        ++begin;
+    while (begin != end  &&  *begin == '0')
+        ++begin;
+    n.integer = begin;
+    while (begin != end  &&  is_digit(*begin))
+        ++begin;
+    n.integer_length = begin - n.integer;
+
+    n.fraction        = begin;
+    n.fraction_length = 0;
+    if (begin != end  &&  *begin == '.')
+    {
+        n.fraction = ++begin;
+        while (begin != end  &&  is_digit(*begin))
+            ++begin;
+        while (begin != n.fraction  &&  begin[-1] == '0')
+            --begin;
+        n.fraction_length = begin - n.fraction;
+    }
+
+    // -0 sorts as 0
+    if (n.integer_length == 0  &&  n.fraction_length == 0)
+        n.negative = false;
+    return n;
+}
+
+// the first eight bytes of a key, big-endian and padded with zero
+std::uint64_t text_prefix(char const *begin, char const *end)
+{
+    std::uint64_t prefix = 0;
+    auto const length = std::min<size_t>(end - begin, 8);
+    for (size_t loop=0; loop<8; ++loop)
+        prefix = (prefix << 8) | (loop < length? static_cast<unsigned char>(begin[loop]) : 0);
+    return prefix;
+}
+
+int compare_bytes(char const *first, size_t first_length, char const *second, size_t second_length)
+{
+    auto const result = std::memcmp(first, second, std::min(first_length, second_length));
+    if (result != 0)
+        return result;
+    return (first_length < second_length)? -1 : (first_length > second_length);
+}
+
+// exact comparison of two numbers, which the prefixes of keys beyond the precision
+// of a double cannot tell apart
+int compare_numbers(number const &first, number const &second)
+{
+    if (first.negative != second.negative)
+        return first.negative? -1 : 1;
+
+    int result;
+    if (first.integer_length != second.integer_length)
+        result = (first.integer_length < second.integer_length)? -1 : 1;
+    else
+        result = std::memcmp(first.integer, second.integer, first.integer_length);
+    if (result == 0)
+        result = compare_bytes(first.fraction, first.fraction_length, second.fraction, second.fraction_length);
+    return first.negative? -result : result;
+}
+
+class line_less
+{
+  public:
+    line_less(char const *data, options const &options)
+      : data_(data),
+        numeric_(options.numeric),
+        reverse_(options.reverse),
+        whole_line_(!options.numeric  &&  options.first_field == 0)
+    {
+    }
+
+    bool operator()(line const &first, line const &second) const
+    {
+        return reverse_? less(second, first) : less(first, second);
+    }
+
+  private:
+    bool less(line const &first, line const &second) const
+    {
+        if (first.prefix != second.prefix)
+            return first.prefix < second.prefix;
+
+        auto const first_key  = data_ + first.offset + first.key_offset;
+        auto const second_key = data_ + second.offset + second.key_offset;
+        if (numeric_)
+        {
+            auto const result = compare_numbers(
+                parse_number(first_key, first_key + first.key_length),
+                parse_number(second_key, second_key + second.key_length));
+            if (result != 0)
+                return result < 0;
+        }
+        else
+        {
+            // the prefix holds the first eight bytes of the keys
+            auto const skip   = std::min<size_t>(8, std::min(first.key_length, second.key_length));
+            auto const result = compare_bytes(
+                first_key + skip,  first.key_length - skip,
+                second_key + skip, second.key_length - skip);
+            if (result != 0  ||  whole_line_)
+                return result < 0;
+        }
+
+        // last resort comparison of the whole line
+        return compare_bytes(data_ + first.offset, first.length, data_ + second.offset, second.length) < 0;
+    }
+
+    char const *data_;
+    bool        numeric_;
+    bool        reverse_;
+    bool        whole_line_;
+};
+
+std::vector<line> index_lines(input const &in, options const &options)
+{
+    std::vector<line> lines;
+    lines.reserve(in.size() / 64);
+
+    auto const data = in.data();
+    auto const end  = data + in.size();
+    for (auto begin=data; begin!=end; )
+    {
+        auto eol = static_cast<char const *>(std::memchr(begin, '\n', end - begin));
+        if (!eol)
+            eol = end;
+        if (size_t(eol - begin) > UINT32_MAX)
+            throw std::length_error("line longer than 4 GiB at byte " + std::to_string(begin - data));
+
+        auto key_begin = begin;
+        auto key_end   = eol;
+        if (options.first_field != 0)
+        {
+            key_begin = field(begin, eol, options.first_field, options.separator);
+            if (options.last_field != 0)
+                key_end = field_end(field(key_begin, eol, options.last_field - options.first_field + 1, options.separator), eol, options.separator);
+            key_end = std::max(key_begin, key_end);
+        }
+
+        line l;
+        l.prefix     = options.numeric? numeric_prefix(key_begin, key_end) : text_prefix(key_begin, key_end);
+        l.offset     = begin - data;
+        l.length     = static_cast<std::uint32_t>(eol - begin);
+        l.key_offset = static_cast<std::uint32_t>(key_begin - begin);
+        l.key_length = static_cast<std::uint32_t>(key_end - key_begin);
+        lines.push_back(l);
+
+        begin = (eol == end)? end : eol + 1;
+    }
+    return lines;
+}
+
+// write the lines in order with as few system calls as possible
+void write_lines(input const &in, std::vector<line> const &lines)
+{
+    static char newline = '\n';
+    std::vector<iovec> iov;
+    iov.reserve(IOV_MAX);
+
+    auto const flush = [&iov]() {
+        auto it = iov.begin();
+        while (it != iov.end())
+        {
+            auto written = ::writev(STDOUT_FILENO, &*it, static_cast<int>(iov.end() - it));
+            if (written == -1  &&  errno == EINTR)
+                continue;
+            else if (written == -1)
+                throw std::system_error(errno, std::system_category(), "standard output");
+
+            // skip the buffers that have been written, and the written part of the next
+            for (; it != iov.end()  &&  size_t(written) >= it->iov_len; ++it)
+                written -= it->iov_len;
+            if (it != iov.end())
+            {
+                it->iov_base = static_cast<char *>(it->iov_base) + written;
+                it->iov_len -= written;
+            }
+        }
+        iov.clear();
+    };
+
+    for (auto const &l : lines)
+    {
+        if (iov.size() + 2 > IOV_MAX)
+            flush();
+
+        // lines are written with the newline that follows them in the input
+        auto const base = const_cast<char *>(in.data() + l.offset);
+        if (l.offset + l.length < in.size())
+            iov.push_back(iovec{ base, size_t(l.length) + 1 });
+        else
+        {
+            iov.push_back(iovec{ base, l.length });
+            iov.push_back(iovec{ &newline, 1 });
+        }
+    }
+    flush();
+}
+
+int usage()
+{
+    std::cerr << "usage: cdmh_sort [-n] [-r] [-t char] [-k field[,field]] [--parallel=threads] [file...]\n";
+    return EXIT_FAILURE;
+}
+
+}   // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    options options;
+    std::vector<std::string> paths;
+    for (int arg=1; arg<argc; ++arg)
+    {
+        std::string const option(argv[arg]);
+        if (option == "-n")
+            options.numeric = true;
+        else if (option == "-r")
+            options.reverse = true;
+        else if (option == "-t"  &&  arg+1 < argc  &&  std::strlen(argv[arg+1]) == 1)
+            options.separator = argv[++arg][0];
+        else if (option == "-k"  &&  arg+1 < argc)
+        {
+            char *end;
+            options.first_field = std::strtoul(argv[++arg], &end, 10);
+            if (*end == ',')
+                options.last_field = std::strtoul(end + 1, &end, 10);
+            if (*end != 0  ||  options.first_field == 0  ||  (options.last_field != 0  &&  options.last_field < options.first_field))
+                return usage();
+        }
+        else if (option.compare(0, 11, "--parallel=") == 0)
+            options.threads = std::strtoul(option.c_str() + 11, nullptr, 10);
+        else if (option.size() > 1  &&  option[0] == '-')
+            return usage();
+        else
+            paths.push_back(option);
+    }
+
+    try
+    {
+        input const in(paths);
+        auto lines = index_lines(in, options);
+        cdmh::parallel_sort(lines.begin(), lines.end(), line_less(in.data(), options), options.threads);
+        write_lines(in, lines);
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << "cdmh_sort: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
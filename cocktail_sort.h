@@ -1,6 +1,8 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "sort.h"
 
 namespace cdmh {
@@ -13,8 +15,10 @@ namespace cdmh {
 //     Wost case space complexity   O(1)
 // http://en.wikipedia.org/wiki/Cocktail_sort
 
-template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void cocktail_sort(It begin, It end, Pred pred=Pred())
+namespace detail {
+
+template<typename It, typename Pred>
+inline void cocktail_sort(It begin, It end, Pred pred)
 {
     if (std::distance(begin, end) <= 1)
         return;
@@ -55,6 +59,15 @@ inline void cocktail_sort(It begin, It end, Pred pred=Pred())
     }
 }
 
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline void cocktail_sort(It begin, It end, Pred pred=Pred())
+{
+    auto const range = detail::kernel_range(begin, end);
+    detail::cocktail_sort(range.first, range.second, pred);
+}
+
 }   // namespace cdmh
 
 // Permission is hereby granted, free of charge, to any person obtaining a copy
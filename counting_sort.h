@@ -0,0 +1,224 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "introsort.h"
+#include "merge_sort.h"
+#include "scratch.h"
+#include <algorithm>        // min, max
+#include <cassert>
+#include <cstdint>      // SIZE_MAX
+#include <type_traits>
+#include <vector>
+
+namespace cdmh {
+
+// Counting Sort
+//     Worst case performance       O(n + k) for k possible keys
+//     Worst case space complexity  O(n + k) auxiliary
+// http://en.wikipedia.org/wiki/Counting_sort
+//
+// a stable sort of elements by an integral key taken from each element by a key
+// function, for keys in a range [min, max] that is given or found with a pass over
+// the data. the keys are counted into a histogram, a prefix sum of which gives the
+// position of the first element with each key, and the elements are moved from a
+// buffer to their positions in their original order. a range of keys that is found
+// whether given or found is counted only if it is smaller than the number of elements;
+// otherwise the elements are sorted with merge_sort comparing the keys, which is also
+// stable. sort_by_key samples the keys
+// and uses the counting sort if the range of keys is small relative to the number
+// of elements, or introsort, which is not stable, comparing the keys otherwise. the
+// buffer and histogram are allocated with the allocator given
+
+namespace detail {
+
+// the key of an element that is its own key
+struct identity_key
+{
+    template<typename T>
+    T const &operator()(T const &value) const
+    {
+        return value;
+    }
+};
+
+// number of keys sampled by sort_by_key to estimate the range of keys
+size_t const counting_sort_samples = 64;
+
+// the unsigned type of a key's width; std::make_unsigned is ill-formed for bool
+template<typename K>
+struct unsigned_key : std::make_unsigned<K>
+{
+};
+
+template<>
+struct unsigned_key<bool>
+{
+    using type = unsigned char;
+};
+
+// the position of a key in the histogram, as an offset from the smallest key
+template<typename K>
+inline size_t key_offset(K key, K min)
+{
+    using unsigned_t = typename unsigned_key<K>::type;
+    return size_t(unsigned_t(unsigned_t(key) - unsigned_t(min)));
+}
+
+// true if the keys [min, max] span fewer values than there are elements
+template<typename K>
+inline bool small_key_range(K min, K max, size_t size)
+{
+    return detail::key_offset(max, min) < size;
+}
+
+// stable sort by comparing keys, for ranges of keys that are too large to count
+template<typename It, typename Key, typename Alloc>
+inline void compare_keys_sort(It begin, It end, Key &key, Alloc const &alloc)
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+    cdmh::merge_sort(begin, end, [&key](value_type const &first, value_type const &second) {
+        return key(first) < key(second);
+    }, alloc);
+}
+
+// scatter the buffered elements directly to their positions in the range
+template<typename It, typename Buffer, typename Positions, typename Key, typename K>
+inline void counting_sort_scatter(It begin, Buffer &buffer, Positions &positions, Key &key, K min, std::random_access_iterator_tag)
+{
+    for (auto &value : buffer)
+        begin[positions[detail::key_offset<K>(key(value), min)]++] = std::move(value);
+}
+
+// without random access, scatter the buffer indices and move the elements in order
+template<typename It, typename Buffer, typename Positions, typename Key, typename K>
+inline void counting_sort_scatter(It begin, Buffer &buffer, Positions &positions, Key &key, K min, std::forward_iterator_tag)
+{
+    Positions order(buffer.size(), 0, positions.get_allocator());
+    for (size_t loop=0; loop<buffer.size(); ++loop)
+        order[positions[detail::key_offset<K>(key(buffer[loop]), min)]++] = loop;
+    for (auto const index : order)
+        *begin++ = std::move(buffer[index]);
+}
+
+}   // namespace detail
+
+template<typename It, typename Key, typename K, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void counting_sort(It begin, It end, Key key, K min, K max, Alloc const &alloc=Alloc())
+{
+    static_assert(std::is_integral<K>::value, "counting sort requires integral keys");
+    if (std::distance(begin, end) <= 1)
+        return;
+    assert(!(max < min));
+
+    // the histogram has an entry for each key and one more, so is sized only if there
+    // are fewer keys than elements
+    if (!detail::small_key_range(min, max, std::distance(begin, end)))
+    {
+        detail::compare_keys_sort(begin, end, key, alloc);
+        return;
+    }
+    auto const range = detail::kernel_range(begin, end);
+
+    detail::scratch_vector<typename std::iterator_traits<It>::value_type, Alloc> buffer(std::make_move_iterator(range.first), std::make_move_iterator(range.second), alloc);
+
+    // positions[k] is the number of elements with a key less than min+k
+    detail::scratch_vector<size_t, Alloc> positions(detail::key_offset(max, min) + 2, 0, alloc);
+    for (auto const &value : buffer)
+    {
+        auto const k = key(value);
+        assert(!(k < min)  &&  !(max < k));
+        ++positions[detail::key_offset<K>(k, min) + 1];
+    }
+    for (size_t loop=1; loop<positions.size(); ++loop)
+        positions[loop] += positions[loop - 1];
+
+    detail::counting_sort_scatter(range.first, buffer, positions, key, min, typename std::iterator_traits<decltype(range.first)>::iterator_category());
+}
+
+template<typename It, typename Key=detail::identity_key, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void counting_sort(It begin, It end, Key key=Key(), Alloc const &alloc=Alloc())
+{
+    if (begin == end)
+        return;
+
+    using key_type = typename std::decay<decltype(key(*begin))>::type;
+    key_type min = key(*begin);
+    key_type max = min;
+    for (It it=begin; it!=end; ++it)
+    {
+        key_type const k = key(*it);
+        min = std::min(min, k);
+        max = std::max(max, k);
+    }
+
+    if (detail::small_key_range(min, max, std::distance(begin, end)))
+        counting_sort(begin, end, key, min, max, alloc);
+    else
+        detail::compare_keys_sort(begin, end, key, alloc);
+}
+
+template<typename It, typename Key=detail::identity_key, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void sort_by_key(It begin, It end, Key key=Key(), Alloc const &alloc=Alloc())
+{
+    size_t const size = std::distance(begin, end);
+    if (size <= 1)
+        return;
+
+    // a sample whose keys span more than the number of elements rules out a counting sort;
+    // otherwise the exact range is found and checked before the counting sort is used
+    using key_type = typename std::decay<decltype(key(*begin))>::type;
+    size_t const samples = std::min(size, detail::counting_sort_samples);
+    key_type min = key(*begin);
+    key_type max = min;
+    It it = begin;
+    for (size_t sample=1; sample<samples; ++sample)
+    {
+        std::advance(it, size * sample / samples - size * (sample - 1) / samples);
+        key_type const k = key(*it);
+        min = std::min(min, k);
+        max = std::max(max, k);
+    }
+
+    if (detail::small_key_range(min, max, size))
+    {
+        for (it=begin; it!=end; ++it)
+        {
+            key_type const k = key(*it);
+            min = std::min(min, k);
+            max = std::max(max, k);
+        }
+        if (detail::small_key_range(min, max, size))
+        {
+            counting_sort(begin, end, key, min, max, alloc);
+            return;
+        }
+    }
+
+    using value_type = typename std::iterator_traits<It>::value_type;
+    cdmh::introsort(begin, end, [&key](value_type const &first, value_type const &second) {
+        return key(first) < key(second);
+    });
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,171 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "sort_sampler.h"
+#include "scratch.h"
+#include <algorithm>    // merge, min
+#include <atomic>
+#include <iterator>     // make_move_iterator
+#include <memory>       // addressof
+#include <thread>
+#include <type_traits>
+
+namespace cdmh {
+
+namespace detail {
+
+// the runs of elements of [begin, end) that are contiguous in memory
+template<typename It, typename Alloc>
+inline scratch_vector<std::pair<typename std::iterator_traits<It>::pointer, typename std::iterator_traits<It>::pointer>, Alloc> contiguous_blocks(It begin, It end, Alloc const &alloc)
+{
+    using pointer = typename std::iterator_traits<It>::pointer;
+    scratch_vector<std::pair<pointer, pointer>, Alloc> blocks(alloc);
+    if (begin == end)
+        return blocks;
+
+    pointer first = std::addressof(*begin);
+    pointer last  = first + 1;
+    for (++begin; begin!=end; ++begin, ++last)
+    {
+        pointer const element = std::addressof(*begin);
+        if (element != last)
+        {
+            blocks.push_back(std::make_pair(first, last));
+            first = last = element;
+        }
+    }
+    blocks.push_back(std::make_pair(first, last));
+    return blocks;
+}
+
+// run task(index) for each index in [0, count), shared between the threads
+template<typename Task, typename Alloc>
+inline void share_tasks(size_t count, unsigned threads, Task const &task, Alloc const &alloc)
+{
+    std::atomic<size_t> next(0);
+    auto const run = [&]() {
+        detail::nested_sample_scope nested;
+        for (size_t index; (index = next++) < count; )
+            task(index);
+    };
+    scratch_vector<std::thread, Alloc> workers(alloc);
+    for (size_t thread=1; thread<std::min<size_t>(threads, count); ++thread)
+        workers.emplace_back(run);
+    run();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+// move each contiguous block of [begin, end) into a buffer and sort it there with
+// sort_block(first, last, pred), then merge pairs of sorted runs, a pass at a time,
+// alternately from the buffer into the range and back. the buffer is move
+// constructed, so the elements need not be default constructible. the merges are
+// stable, so the sort is stable if sort_block is
+template<typename It, typename Pred, typename SortBlock, typename Alloc>
+inline void sort_blocks(It begin, It end, Pred &pred, SortBlock const &sort_block, unsigned threads, Alloc const &alloc)
+{
+    auto const blocks = detail::contiguous_blocks(begin, end, alloc);
+    if (blocks.size() <= 1)
+    {
+        for (auto const &block : blocks)
+            sort_block(block.first, block.second, pred);
+        return;
+    }
+
+    // the blocks are the first runs, bounded by offsets from the start of the range
+    detail::scratch_vector<typename std::iterator_traits<It>::value_type, Alloc> buffer(alloc);
+    buffer.reserve(std::distance(begin, end));
+    detail::scratch_vector<size_t, Alloc> bounds(1, 0, alloc);
+    for (auto const &block : blocks)
+    {
+        buffer.insert(buffer.end(), std::make_move_iterator(block.first), std::make_move_iterator(block.second));
+        bounds.push_back(buffer.size());
+    }
+    auto const data = buffer.data();
+    detail::share_tasks(blocks.size(), threads, [&bounds, &pred, &sort_block, data](size_t block) {
+        sort_block(data + bounds[block], data + bounds[block + 1], pred);
+    }, alloc);
+
+    // merge pairs of runs, moving the elements between the buffer and the range
+    bool in_buffer = true;
+    while (bounds.size() > 2)
+    {
+        detail::share_tasks((bounds.size() - 1) / 2 + (bounds.size() - 1) % 2, threads, [&](size_t pair) {
+            auto const first  = bounds[2 * pair];
+            auto const middle = bounds[std::min(2 * pair + 1, bounds.size() - 1)];
+            auto const last   = bounds[std::min(2 * pair + 2, bounds.size() - 1)];
+            if (in_buffer)
+            {
+                std::merge(
+                    std::make_move_iterator(data + first), std::make_move_iterator(data + middle),
+                    std::make_move_iterator(data + middle), std::make_move_iterator(data + last),
+                    begin + first, pred);
+            }
+            else
+            {
+                std::merge(
+                    std::make_move_iterator(begin + first), std::make_move_iterator(begin + middle),
+                    std::make_move_iterator(begin + middle), std::make_move_iterator(begin + last),
+                    data + first, pred);
+            }
+        }, alloc);
+
+        detail::scratch_vector<size_t, Alloc> merged(alloc);
+        for (size_t loop=0; loop<bounds.size(); loop+=2)
+            merged.push_back(bounds[loop]);
+        if (merged.back() != bounds.back())
+            merged.push_back(bounds.back());
+        bounds.swap(merged);
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer)
+        std::move(buffer.begin(), buffer.end(), begin);
+}
+
+template<typename It, typename Pred, typename Sort, typename Alloc>
+CDMH_CONSTEXPR void sort_kernel(It begin, It end, Pred &pred, Sort const &sort, Alloc const &, std::false_type)
+{
+    auto const range = detail::kernel_range(begin, end);
+    sort(range.first, range.second, pred);
+}
+
+template<typename It, typename Pred, typename Sort, typename Alloc>
+inline void sort_kernel(It begin, It end, Pred &pred, Sort const &sort, Alloc const &alloc, std::true_type)
+{
+    detail::sort_blocks(begin, end, pred, sort, 1, alloc);
+}
+
+// sort [begin, end) with sort(first, last, pred) on the kernel range of the iterators
+// or, for the iterators of a deque, on each of its blocks, which are then merged
+// through a buffer allocated with the allocator given. only sorts that already need
+// O(n) memory use this, so the in-place sorts stay in place on a deque
+template<typename It, typename Pred, typename Sort, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+CDMH_CONSTEXPR void sort_kernel(It begin, It end, Pred &pred, Sort const &sort, Alloc const &alloc=Alloc())
+{
+    detail::sort_kernel(begin, end, pred, sort, alloc, is_deque_iterator<It>());
+}
+
+}   // namespace detail
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,76 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "sort_sampler.h"
+#include "deque_sort.detail.h"
+#include "insertion_sort.h"
+#include "introsort.h"
+
+namespace cdmh {
+
+// Deque Sort
+//     Worst case performance       O(n log n)
+//     Average case performance     O(n log n)
+//     Worst case space complexity  O(n) auxiliary
+//
+// sorts a random access range whose elements are held in contiguous blocks, such as
+// a std::deque, without the cost of crossing block boundaries on every random access
+// iterator operation. the blocks are found with one pass over the range, comparing
+// the address of each element with the one before, and each block is sorted through
+// pointers, with insertion sort if small or introsort otherwise. the blocks are moved
+// into a buffer allocated with the allocator given and sorted there, and pairs of
+// sorted runs are then merged, a pass at a time, alternately from the buffer into the
+// range and back, so both sides are read and written sequentially. the blocks, and
+// the merges of each pass, can be shared between a number of threads. the list of
+// blocks is also allocated with the allocator given. merge_sort sorts the iterators
+// of a std::deque in the same way on the calling thread, sorting the blocks itself
+
+namespace detail {
+
+// blocks of this many elements or fewer are sorted with an insertion sort
+size_t const deque_sort_insertion_max = 128;
+
+// sort a block with an insertion sort if small, or introsort otherwise
+struct deque_sort_block
+{
+    template<typename T, typename Pred>
+    void operator()(T *begin, T *end, Pred &pred) const
+    {
+        if (size_t(end - begin) <= deque_sort_insertion_max)
+            detail::insertion_sort(begin, end, pred);
+        else
+            cdmh::introsort(begin, end, pred);
+    }
+};
+
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void deque_sort(It begin, It end, Pred pred=Pred(), unsigned threads=1, Alloc const &alloc=Alloc())
+{
+    detail::sample_scope<It, Pred> sample(sort_sample::deque_sort, begin, end, pred);
+    detail::sort_blocks(begin, end, pred, detail::deque_sort_block(), threads, alloc);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -4,6 +4,8 @@
 #pragma once
 
 #include "sort.h"
+#include "sort_sampler.h"
+#include "sort_trace.h"
 #include <algorithm>    // make_heap
 
 namespace cdmh {
@@ -15,13 +17,26 @@ namespace cdmh {
 //     Worst case space complexity  O(n) total, O(1) auxiliary
 // http://en.wikipedia.org/wiki/Heapsort
 
-template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void heap_sort(It begin, It end, Pred pred=Pred())
+namespace detail {
+
+template<typename It, typename Pred>
+CDMH_CONSTEXPR void heap_sort(It begin, It end, Pred pred)
 {
+    detail::trace_span span(trace_event::leaf_sort, "heap_sort", size_t(std::distance(begin, end)));
     std::make_heap(begin, end, pred);
     std::sort_heap(begin, end, pred);
 }
 
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+CDMH_CONSTEXPR void heap_sort(It begin, It end, Pred pred=Pred())
+{
+    detail::sample_scope<It, Pred> sample(sort_sample::heap_sort, begin, end, pred);
+    auto const range = detail::kernel_range(begin, end);
+    detail::heap_sort(range.first, range.second, pred);
+}
+
 }   // namespace cdmh
 
 // Permission is hereby granted, free of charge, to any person obtaining a copy
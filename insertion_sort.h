@@ -1,7 +1,10 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "sort.h"
+#include "sort_sampler.h"
 
 namespace cdmh {
 
@@ -12,8 +15,10 @@ namespace cdmh {
 //    Worst case space complexity       О(n) total, O(1)
 // http://en.wikipedia.org/wiki/Insertion_sort
 
-template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void insertion_sort(It begin, It end, Pred pred=Pred())
+namespace detail {
+
+template<typename It, typename Pred>
+CDMH_CONSTEXPR void insertion_sort(It begin, It end, Pred pred)
 {
     if (begin == end)
         return;
@@ -37,6 +42,16 @@ inline void insertion_sort(It begin, It end, Pred pred=Pred())
     }
 }
 
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+CDMH_CONSTEXPR void insertion_sort(It begin, It end, Pred pred=Pred())
+{
+    detail::sample_scope<It, Pred> sample(sort_sample::insertion_sort, begin, end, pred);
+    auto const range = detail::kernel_range(begin, end);
+    detail::insertion_sort(range.first, range.second, pred);
+}
+
 }   // namespace cdmh
 
 // Permission is hereby granted, free of charge, to any person obtaining a copy
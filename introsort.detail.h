@@ -1,8 +1,11 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "quicksort.detail.h"
 #include "heap_sort.h"
+#include <cmath>    // floor, log
 
 namespace cdmh {
 
@@ -14,7 +17,7 @@ template<typename It, bool IsRandomIterator=std::is_same<typename std::iterator_
 struct heap_sort_if_we_can
 {
     template<typename... Args>
-    bool operator()(Args...)
+    CDMH_CONSTEXPR bool operator()(Args...)
     {
         return false;
     }
@@ -24,21 +27,35 @@ template<typename It>
 struct heap_sort_if_we_can<It, true>
 {
     template<typename Pred>
-    bool operator()(It begin, It end, Pred pred)
+    CDMH_CONSTEXPR bool operator()(It begin, It end, Pred pred)
     {
-        heap_sort(begin, end, pred);
+        detail::heap_sort(begin, end, pred);
         return true;
     }
 };
 
+// the depth of partitioning after which introsort falls back to heap sort. log() is
+// not constexpr, so at compile time the depth is found from the integer log2 instead
+CDMH_CONSTEXPR size_t introsort_depth(size_t size)
+{
+    if (CDMH_CONSTANT_EVALUATED())
+    {
+        size_t depth = 0;
+        while (size >>= 1)
+            ++depth;
+        return depth;
+    }
+    return (size_t)floor(log(size/log(2.0)));
+}
 
 // detail introsort implementation takes a depth count
 template<typename It, typename Pred>
-inline void introsort(It begin, It end, Pred pred, size_t depth)
+CDMH_CONSTEXPR void introsort(It begin, It end, Pred pred, size_t depth)
 {
     auto const size = std::distance(begin, end);
     if (size <= 1)
         return;
+    detail::trace_span span(trace_event::sort, "introsort", size_t(size));
 
     // if we've reached the depth limit, then attempt a heap sort.
     // if heap sort is not available to us, then continue with quicksort algorithm
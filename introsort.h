@@ -1,9 +1,11 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "sort.h"
+#include "sort_sampler.h"
 #include "introsort.detail.h"
-#include <cmath>    // floor, log
 
 namespace cdmh {
 
@@ -13,10 +15,14 @@ namespace cdmh {
 // http://en.wikipedia.org/wiki/Introsort
 
 template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void introsort(It begin, It end, Pred pred=Pred())
+CDMH_CONSTEXPR void introsort(It begin, It end, Pred pred=Pred())
 {
+    detail::sample_scope<It, Pred> sample(sort_sample::introsort, begin, end, pred);
     if (std::distance(begin, end) > 1)
-        detail::introsort(begin, end, pred, (size_t)floor(log(std::distance(begin,end)/log(2.0))));
+    {
+        auto const range = detail::kernel_range(begin, end);
+        detail::introsort(range.first, range.second, pred, detail::introsort_depth(std::distance(begin, end)));
+    }
 }
 
 }   // namespace cdmh
@@ -0,0 +1,294 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "scratch.h"
+#include "sort_trace.h"
+#include <algorithm>    // lower_bound, upper_bound
+#include <thread>
+#include <utility>      // pair
+#include <vector>
+
+namespace cdmh {
+
+namespace detail {
+
+// value type of the elements of a sequence of (begin, end) iterator pairs
+template<typename RangeIt>
+struct range_value
+{
+    using type = typename std::iterator_traits<
+        typename std::iterator_traits<RangeIt>::value_type::first_type>::value_type;
+};
+
+// tournament tree of losers over k sorted runs. each internal node holds the head
+// of the run that lost the match played at that node, and node 0 holds the overall
+// winner, so replacing the winner costs one comparison per level, O(log k). the
+// nodes hold the heads themselves rather than run indices, so a match reads only the
+// two elements it compares. ties are won by the run with the lower index, which
+// makes the merge stable. the tree is allocated with the allocator given
+template<typename It, typename Pred, typename Alloc=std::allocator<It>>
+class loser_tree
+{
+  public:
+    template<typename Runs>
+    loser_tree(Runs const &runs, Pred pred, Alloc const &alloc=Alloc())
+      : ends_(runs.size(), It(), alloc),
+        tree_(alloc),
+        pred_(pred)
+    {
+        scratch_vector<entry, Alloc> leaves(alloc);
+        leaves.reserve(runs.size());
+        for (size_t run=0; run<runs.size(); ++run)
+        {
+            ends_[run] = runs[run].second;
+            leaves.push_back(entry(runs[run].first, run, runs[run].first != runs[run].second));
+        }
+        tree_.resize(std::max<size_t>(runs.size(), 1), entry(It(), 0, false));
+        if (!runs.empty())
+            tree_[0] = build(1, leaves);
+    }
+
+    bool empty() const
+    {
+        return !tree_[0].live;
+    }
+
+    // the run holding the current smallest element
+    size_t winner() const
+    {
+        return tree_[0].run;
+    }
+
+    It const &top() const
+    {
+        return tree_[0].head;
+    }
+
+    void pop()
+    {
+        entry winner = tree_[0];
+        winner.live = ++winner.head != ends_[winner.run];
+        for (auto node=(winner.run + ends_.size()) / 2; node > 0; node /= 2)
+        {
+            if (beats(tree_[node], winner))
+                std::swap(tree_[node], winner);
+        }
+        tree_[0] = winner;
+    }
+
+  private:
+    struct entry
+    {
+        entry(It head, size_t run, bool live) : head(head), run(run), live(live)
+        {
+        }
+
+        It     head;
+        size_t run;
+        bool   live;    // the run is not exhausted
+    };
+
+    // true if the head of `a` is output before the head of `b`
+    bool beats(entry const &a, entry const &b) const
+    {
+        if (!a.live  ||  !b.live)
+            return a.live;
+        return pred_(*a.head, *b.head)  ||  (a.run < b.run  &&  !pred_(*b.head, *a.head));
+    }
+
+    // nodes [1, k) are internal, nodes [k, 2k) are the leaves of runs [0, k)
+    template<typename Leaves>
+    entry build(size_t node, Leaves const &leaves)
+    {
+        if (node >= leaves.size())
+            return leaves[node - leaves.size()];
+
+        auto const left  = build(node * 2, leaves);
+        auto const right = build(node * 2 + 1, leaves);
+        if (beats(left, right))
+        {
+            tree_[node] = right;
+            return left;
+        }
+        tree_[node] = left;
+        return right;
+    }
+
+    scratch_vector<It, Alloc>    ends_;
+    scratch_vector<entry, Alloc> tree_;
+    Pred                         pred_;
+};
+
+// co-ranking: find the position in each sorted run at which the stable merged
+// output of all the runs would be split to put `rank` elements before the split.
+// the element at `rank` is located by binary search over each run in turn, counting
+// elements across all runs with lower_bound/upper_bound, so random access iterators
+// are needed for this to be efficient. elements equal to the splitting value are
+// allocated to runs in run order, which keeps a split merge stable
+template<typename Runs, typename Pred, typename Alloc>
+scratch_vector<typename Runs::value_type::first_type, Alloc> co_rank(Runs const &runs, size_t rank, Pred pred, Alloc const &alloc)
+{
+    using It      = typename Runs::value_type::first_type;
+    using value_t = typename std::iterator_traits<It>::value_type;
+
+    auto const count_less = [&runs, &pred](value_t const &value) {
+        size_t count = 0;
+        for (auto const &run : runs)
+            count += std::distance(run.first, std::lower_bound(run.first, run.second, value, pred));
+        return count;
+    };
+    auto const count_not_greater = [&runs, &pred](value_t const &value) {
+        size_t count = 0;
+        for (auto const &run : runs)
+            count += std::distance(run.first, std::upper_bound(run.first, run.second, value, pred));
+        return count;
+    };
+
+    scratch_vector<It, Alloc> splits(alloc);
+    splits.reserve(runs.size());
+    for (auto const &run : runs)
+    {
+        // first element of this run that has more than `rank` elements not greater than it
+        auto first = run.first;
+        auto count = std::distance(run.first, run.second);
+        while (count > 0)
+        {
+            auto const step = count / 2;
+            auto const it   = detail::advance(first, step);
+            if (count_not_greater(*it) <= rank)
+            {
+                first = detail::advance(it, 1);
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+
+        if (first == run.second)
+            continue;
+
+        auto const less = count_less(*first);
+        if (less > rank)
+            continue;
+
+        // *first is equivalent to the element at `rank`
+        auto remaining = rank - less;
+        for (auto const &run : runs)
+        {
+            auto const lower = std::lower_bound(run.first, run.second, *first, pred);
+            auto const upper = std::upper_bound(lower, run.second, *first, pred);
+            auto const take  = std::min<size_t>(remaining, std::distance(lower, upper));
+            splits.push_back(detail::advance(lower, take));
+            remaining -= take;
+        }
+        return splits;
+    }
+
+    // rank is at or beyond the end of the merged output
+    for (auto const &run : runs)
+        splits.push_back(run.second);
+    return splits;
+}
+
+// copy, or move, an element from a run to the output of a merge
+template<bool Move>
+struct transfer
+{
+    template<typename T>
+    static T const &apply(T const &value)
+    {
+        return value;
+    }
+};
+
+template<>
+struct transfer<true>
+{
+    template<typename T>
+    static T &&apply(T &value)
+    {
+        return std::move(value);
+    }
+};
+
+template<bool Move, typename Tree, typename Out>
+inline Out drain(Tree &tree, Out result)
+{
+    for (; !tree.empty(); tree.pop())
+        *result++ = transfer<Move>::apply(*tree.top());
+    return result;
+}
+
+template<bool Move, typename Runs, typename Out, typename Pred, typename Alloc>
+inline Out kway_merge(Runs const &runs, Out result, Pred pred, Alloc const &alloc)
+{
+    loser_tree<typename Runs::value_type::first_type, Pred, Alloc> tree(runs, pred, alloc);
+    return drain<Move>(tree, result);
+}
+
+template<bool Move, typename Runs, typename Out, typename Pred, typename Alloc>
+inline Out parallel_kway_merge(Runs const &runs, Out result, Pred pred, unsigned threads, Alloc const &alloc)
+{
+    size_t size = 0;
+    for (auto const &run : runs)
+        size += std::distance(run.first, run.second);
+
+    size_t const parts = std::max<size_t>(1, std::min<size_t>(threads, size));
+
+    // the allocator need not be thread safe, so the tree of every part is built
+    // here, on the calling thread, and the threads only merge
+    using tree_t = loser_tree<typename Runs::value_type::first_type, Pred, Alloc>;
+    scratch_vector<tree_t, Alloc> trees(alloc);
+    trees.reserve(parts);
+    auto begins = co_rank(runs, 0, pred, alloc);
+    for (size_t part=0; part<parts; ++part)
+    {
+        auto ends = co_rank(runs, size * (part + 1) / parts, pred, alloc);
+        scratch_vector<typename Runs::value_type, Alloc> subruns(alloc);
+        subruns.reserve(runs.size());
+        for (size_t loop=0; loop<runs.size(); ++loop)
+            subruns.push_back(std::make_pair(begins[loop], ends[loop]));
+        trees.emplace_back(subruns, pred, alloc);
+        begins.swap(ends);
+    }
+
+    auto const merge_part = [&trees, result, size, parts](size_t part) {
+        auto const rank_begin = size * part / parts;
+        detail::trace_span span(trace_event::merge, "kway_merge", size * (part + 1) / parts - rank_begin);
+        drain<Move>(trees[part], detail::advance(result, rank_begin));
+    };
+
+    scratch_vector<std::thread, Alloc> workers(alloc);
+    for (size_t part=1; part<parts; ++part)
+        workers.emplace_back(merge_part, part);
+    merge_part(0);
+    for (auto &worker : workers)
+        worker.join();
+
+    return detail::advance(result, size);
+}
+
+}   // namespace detail
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,60 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "kway_merge.detail.h"
+
+namespace cdmh {
+
+// K-way Merge
+//     Worst case performance       O(n log k)
+//     Best case performance        O(n log k)
+//     Average case performance     O(n log k)
+//     Worst case space complexity  O(k) auxiliary
+// http://en.wikipedia.org/wiki/K-way_merge_algorithm
+//
+// merges k sorted runs, given as a sequence of (begin, end) iterator pairs, into a
+// single sorted output using a tournament tree of losers. the merge is stable;
+// equivalent elements are output in the order of the runs that hold them. the tree
+// and the list of runs are allocated with the allocator given
+
+template<typename RangeIt, typename Out, typename Pred=std::less<typename detail::range_value<RangeIt>::type>, typename Alloc=std::allocator<typename detail::range_value<RangeIt>::type>>
+inline Out kway_merge(RangeIt first, RangeIt last, Out result, Pred pred=Pred(), Alloc const &alloc=Alloc())
+{
+    using iterator_t = typename std::iterator_traits<RangeIt>::value_type::first_type;
+    detail::scratch_vector<std::pair<iterator_t, iterator_t>, Alloc> const runs(first, last, alloc);
+    return detail::kway_merge<false>(runs, result, pred, alloc);
+}
+
+// parallel merge to a random access output iterator. the output is divided into
+// equal parts by co-ranking the runs, and each part is merged on its own thread.
+// all the scratch memory is allocated on the calling thread
+template<typename RangeIt, typename Out, typename Pred=std::less<typename detail::range_value<RangeIt>::type>, typename Alloc=std::allocator<typename detail::range_value<RangeIt>::type>>
+inline Out parallel_kway_merge(RangeIt first, RangeIt last, Out result, Pred pred=Pred(), unsigned threads=std::thread::hardware_concurrency(), Alloc const &alloc=Alloc())
+{
+    using iterator_t = typename std::iterator_traits<RangeIt>::value_type::first_type;
+    detail::scratch_vector<std::pair<iterator_t, iterator_t>, Alloc> const runs(first, last, alloc);
+    return detail::parallel_kway_merge<false>(runs, result, pred, threads, alloc);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,208 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "insertion_sort.h"
+#include "quicksort.detail.h"
+#include <vector>
+
+namespace cdmh {
+
+// Lazy Sorted View (Incremental Quicksort)
+//     First m elements             O(n + m log m) expected
+//     All elements                 O(n log n) expected
+//     Worst case space complexity  O(log n) expected auxiliary
+// http://en.wikipedia.org/wiki/Partial_sorting#Incremental_sorting
+//
+// a view of a random access range that sorts the range in place only as far as the
+// elements that have been accessed. the first unsorted segment is partitioned with
+// quicksort_splits, and the bounds of the segments that are not yet needed are kept
+// on a stack, so reading the elements in order partitions only the segment holding
+// the next element. reading every element leaves the underlying range fully sorted
+
+namespace detail {
+
+// unsorted segments of this size or smaller are finished with an insertion sort
+size_t const lazy_sort_threshold = 16;
+
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+class lazy_sorted_view
+{
+  public:
+    using reference = typename std::iterator_traits<It>::reference;
+
+    class iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename std::iterator_traits<It>::value_type;
+        using difference_type   = typename std::iterator_traits<It>::difference_type;
+        using pointer           = typename std::iterator_traits<It>::pointer;
+        using reference         = typename std::iterator_traits<It>::reference;
+
+        iterator() : view_(nullptr), index_(0)
+        {
+        }
+
+        iterator(lazy_sorted_view *view, size_t index) : view_(view), index_(index)
+        {
+        }
+
+        reference operator*() const
+        {
+            return (*view_)[index_];
+        }
+
+        pointer operator->() const
+        {
+            return &(*view_)[index_];
+        }
+
+        iterator &operator++()
+        {
+            ++index_;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator it(*this);
+            ++index_;
+            return it;
+        }
+
+        bool operator==(iterator const &other) const
+        {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(iterator const &other) const
+        {
+            return index_ != other.index_;
+        }
+
+      private:
+        lazy_sorted_view *view_;
+        size_t            index_;
+    };
+
+    lazy_sorted_view(It begin, It end, Pred pred=Pred())
+      : begin_(begin),
+        size_(std::distance(begin, end)),
+        sorted_(0),
+        pred_(pred)
+    {
+        bounds_.push_back(size_);
+    }
+
+    // the element at `index` in the sorted order
+    reference operator[](size_t index)
+    {
+        sort_to(index + 1);
+        return begin_[index];
+    }
+
+    // the first `count` elements in sorted order, as a range of the underlying iterator
+    std::pair<It,It> prefix(size_t count)
+    {
+        count = std::min(count, size_);
+        sort_to(count);
+        return std::make_pair(begin_, begin_ + count);
+    }
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(this, size_);
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // number of leading elements that are already in their sorted position
+    size_t sorted() const
+    {
+        return sorted_;
+    }
+
+  private:
+    // put the elements [0, count) into their sorted positions
+    void sort_to(size_t count)
+    {
+        while (sorted_ < count)
+        {
+            // [sorted_, top) is unsorted, but no element in it is less than any before it
+            auto const top = bounds_.back();
+            if (top == sorted_)
+                bounds_.pop_back();
+            else if (top - sorted_ <= detail::lazy_sort_threshold)
+            {
+                cdmh::insertion_sort(begin_ + sorted_, begin_ + top, pred_);
+                sorted_ = top;
+                bounds_.pop_back();
+            }
+            else
+            {
+                auto const splits = detail::quicksort_splits(begin_ + sorted_, begin_ + top, pred_);
+                size_t const first  = splits.first - begin_;
+                size_t const second = splits.second - begin_;
+
+                // the elements equivalent to the pivot are in place once those less are sorted
+                if (second != top)
+                    bounds_.push_back(second);
+                if (first != sorted_)
+                    bounds_.push_back(first);
+                else
+                    sorted_ = second;
+            }
+        }
+    }
+
+    It                  begin_;
+    size_t              size_;
+    size_t              sorted_;
+    Pred                pred_;
+    std::vector<size_t> bounds_;    // stack of the ends of unsorted segments, nearest on top
+};
+
+template<typename It, typename Pred>
+inline lazy_sorted_view<It, Pred> make_lazy_sorted_view(It begin, It end, Pred pred)
+{
+    return lazy_sorted_view<It, Pred>(begin, end, pred);
+}
+
+template<typename It>
+inline lazy_sorted_view<It> make_lazy_sorted_view(It begin, It end)
+{
+    return lazy_sorted_view<It>(begin, end);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
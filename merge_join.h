@@ -0,0 +1,278 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "sort_trace.h"
+#include "sorted_buffer.h"     // gallop_threshold
+#include <algorithm>    // copy, find_if_not, partition_point
+#include <iterator>
+#include <thread>
+#include <utility>      // pair
+#include <vector>
+
+namespace cdmh {
+
+// Merge Join, Set Intersection, Set Difference
+//     Worst case performance       O(n + m + output)
+//     Best case performance        O(k log((n + m) / k) + output) for k groups of keys
+//     Worst case space complexity  O(1) auxiliary
+// http://en.wikipedia.org/wiki/Sort-merge_join
+//
+// joins two ranges sorted by the same order, such as two tables sorted on a key with
+// merge_sort or introsort. the ranges are walked together a group of equivalent keys
+// at a time, and the elements of either range that are skipped to reach the next key
+// of the other are found with a galloping search, which steps over a few elements
+// one at a time and then doubles its step, so skipping d elements costs O(log d)
+// comparisons and a small range is joined with a large one in far fewer comparisons
+// than a linear merge.
+// merge_join calls emit(left, right) with iterators to the joined elements as they
+// are found, without building a result: an inner join emits each pair of equivalent
+// elements, a left join also emits the unmatched elements of the first range with
+// `right` equal to last2, a semi join emits each element of the first range that has
+// a match with the first of its matches, and an anti join emits the unmatched
+// elements of the first range with last2. set_intersection and set_difference write
+// elements of the first range to an output iterator with the same results as the
+// std algorithms. the ranges may hold different types, compared with pred(left,
+// right) and pred(right, left). parallel_merge_join splits both ranges at co-ranked
+// positions, moved to the start of a group of keys so no group is split, and joins
+// each part on its own thread; emit is then called from several threads at once.
+// the galloping search and the parallel join need random access iterators; forward
+// iterators are stepped through linearly
+
+enum class join_kind { inner, left, semi, anti };
+
+namespace detail {
+
+// compares elements of different types with operator<
+struct heterogeneous_less
+{
+    template<typename T, typename U>
+    bool operator()(T const &first, U const &second) const
+    {
+        return first < second;
+    }
+};
+
+// the first element of [begin, end) for which before() is false, where before() is
+// true for a prefix of the range, searching forward from begin one element at a time
+// and then in steps that double
+template<typename It, typename Before>
+inline It gallop_partition_point(It begin, It end, Before before, std::random_access_iterator_tag)
+{
+    // elements before `lo` are known to be before the partition point
+    It lo = begin;
+    for (size_t loop=0; loop<gallop_threshold; ++loop, ++lo)
+    {
+        if (lo == end  ||  !before(*lo))
+            return lo;
+    }
+
+    size_t step = 1;
+    while (size_t(end - lo) >= step  &&  before(*(lo + (step - 1))))
+    {
+        lo += step;
+        step *= 2;
+    }
+    return std::partition_point(lo, lo + std::min<size_t>(step - 1, end - lo), before);
+}
+
+template<typename It, typename Before>
+inline It gallop_partition_point(It begin, It end, Before before, std::forward_iterator_tag)
+{
+    return std::find_if_not(begin, end, before);
+}
+
+// walk two sorted ranges a group of equivalent keys at a time, calling
+// unmatched(begin, end) for the elements of the first range with no equivalent in
+// the second, and matched(begin1, end1, begin2, end2) for each group found in both
+template<typename It1, typename It2, typename Pred, typename Unmatched, typename Matched>
+inline void merge_groups(It1 first1, It1 last1, It2 first2, It2 last2, Pred &pred, Unmatched unmatched, Matched matched)
+{
+    using value1_t = typename std::iterator_traits<It1>::value_type;
+    using value2_t = typename std::iterator_traits<It2>::value_type;
+    using category1_t = typename std::iterator_traits<It1>::iterator_category;
+    using category2_t = typename std::iterator_traits<It2>::iterator_category;
+
+    // each search starts after the element that is already known to be before its
+    // bound, and stops at an element known not to be less than the other range's
+    while (first1 != last1  &&  first2 != last2)
+    {
+        if (pred(*first1, *first2))
+        {
+            auto const &right = *first2;
+            It1 const next = detail::gallop_partition_point(std::next(first1), last1, [&pred, &right](value1_t const &value) {
+                return pred(value, right);
+            }, category1_t());
+            unmatched(first1, next);
+            if ((first1 = next) == last1)
+                break;
+        }
+
+        auto const &left  = *first1;
+        auto const &right = *first2;
+        if (pred(right, left))
+        {
+            first2 = detail::gallop_partition_point(std::next(first2), last2, [&pred, &left](value2_t const &value) {
+                return pred(value, left);
+            }, category2_t());
+        }
+        else
+        {
+            It1 const end1 = detail::gallop_partition_point(std::next(first1), last1, [&pred, &right](value1_t const &value) {
+                return !pred(right, value);
+            }, category1_t());
+            It2 const end2 = detail::gallop_partition_point(std::next(first2), last2, [&pred, &left](value2_t const &value) {
+                return !pred(left, value);
+            }, category2_t());
+            matched(first1, end1, first2, end2);
+            first1 = end1;
+            first2 = end2;
+        }
+    }
+    unmatched(first1, last1);
+}
+
+// join two sorted ranges, emitting `none` as the right element of unmatched elements
+template<typename It1, typename It2, typename Emit, typename Pred>
+inline void merge_join(It1 first1, It1 last1, It2 first2, It2 last2, join_kind kind, Emit &emit, Pred &pred, It2 none)
+{
+    bool const emit_unmatched = (kind == join_kind::left  ||  kind == join_kind::anti);
+    detail::merge_groups(first1, last1, first2, last2, pred,
+        [kind, emit_unmatched, &emit, none](It1 begin, It1 end) {
+            for (; emit_unmatched  &&  begin!=end; ++begin)
+                emit(begin, none);
+        },
+        [kind, &emit](It1 begin1, It1 end1, It2 begin2, It2 end2) {
+            if (kind == join_kind::anti)
+                return;
+            for (; begin1!=end1; ++begin1)
+            {
+                if (kind == join_kind::semi)
+                    emit(begin1, begin2);
+                else
+                {
+                    for (It2 it=begin2; it!=end2; ++it)
+                        emit(begin1, it);
+                }
+            }
+        });
+}
+
+// the positions in each range that split the merged order of the two ranges with
+// `rank` elements before the split, moved back to the start of a group of keys that
+// is found in both ranges. elements of the first range come before equivalent
+// elements of the second
+template<typename It1, typename It2, typename Pred>
+inline std::pair<It1, It2> merge_join_split(It1 first1, It1 last1, It2 first2, It2 last2, size_t rank, Pred &pred)
+{
+    size_t const size1 = last1 - first1;
+    size_t const size2 = last2 - first2;
+    size_t lo = (rank > size2)? rank - size2 : 0;
+    size_t hi = std::min(rank, size1);
+    while (lo < hi)
+    {
+        size_t const split1 = lo + (hi - lo) / 2;
+        if (!pred(first2[rank - split1 - 1], first1[split1]))
+            lo = split1 + 1;
+        else
+            hi = split1;
+    }
+
+    It1 split1 = first1 + lo;
+    It2 split2 = first2 + (rank - lo);
+    if (split2 != last2)
+    {
+        // a key of the second range at the split whose group is also in the first
+        // range starts the part after the split in both ranges
+        split1 = std::lower_bound(first1, split1, *split2, pred);
+        if (split1 != last1  &&  !pred(*split2, *split1))
+            split2 = std::lower_bound(first2, split2, *split1, pred);
+    }
+    return std::make_pair(split1, split2);
+}
+
+}   // namespace detail
+
+template<typename It1, typename It2, typename Emit, typename Pred=detail::heterogeneous_less>
+inline void merge_join(It1 first1, It1 last1, It2 first2, It2 last2, join_kind kind, Emit emit, Pred pred=Pred())
+{
+    detail::merge_join(first1, last1, first2, last2, kind, emit, pred, last2);
+}
+
+// parallel join of random access ranges, calling emit from up to `threads` threads at once
+template<typename It1, typename It2, typename Emit, typename Pred=detail::heterogeneous_less>
+inline void parallel_merge_join(It1 first1, It1 last1, It2 first2, It2 last2, join_kind kind, Emit emit, Pred pred=Pred(), unsigned threads=std::thread::hardware_concurrency())
+{
+    size_t const size  = (last1 - first1) + (last2 - first2);
+    size_t const parts = std::max<size_t>(1, std::min<size_t>(threads, size));
+
+    std::vector<std::pair<It1, It2>> splits;
+    for (size_t part=0; part<=parts; ++part)
+        splits.push_back(detail::merge_join_split(first1, last1, first2, last2, size * part / parts, pred));
+
+    auto const join_part = [&splits, kind, &emit, &pred, last2](size_t part) {
+        auto const &begin = splits[part];
+        auto const &end   = splits[part + 1];
+        detail::trace_span span(trace_event::merge, "merge_join", (end.first - begin.first) + (end.second - begin.second));
+        detail::merge_join(begin.first, end.first, begin.second, end.second, kind, emit, pred, last2);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t part=1; part<parts; ++part)
+        workers.emplace_back(join_part, part);
+    join_part(0);
+    for (auto &worker : workers)
+        worker.join();
+}
+
+template<typename It1, typename It2, typename Out, typename Pred=detail::heterogeneous_less>
+inline Out set_intersection(It1 first1, It1 last1, It2 first2, It2 last2, Out result, Pred pred=Pred())
+{
+    // the first min(n, m) elements of a group of n in the first range and m in the second
+    detail::merge_groups(first1, last1, first2, last2, pred,
+        [](It1, It1) {
+        },
+        [&result](It1 begin1, It1 end1, It2 begin2, It2 end2) {
+            for (; begin1!=end1  &&  begin2!=end2; ++begin1, ++begin2)
+                *result++ = *begin1;
+        });
+    return result;
+}
+
+template<typename It1, typename It2, typename Out, typename Pred=detail::heterogeneous_less>
+inline Out set_difference(It1 first1, It1 last1, It2 first2, It2 last2, Out result, Pred pred=Pred())
+{
+    // the last n - m elements of a group of n in the first range and m in the second
+    detail::merge_groups(first1, last1, first2, last2, pred,
+        [&result](It1 begin, It1 end) {
+            result = std::copy(begin, end, result);
+        },
+        [&result](It1 begin1, It1 end1, It2 begin2, It2 end2) {
+            for (; begin1!=end1  &&  begin2!=end2; ++begin1, ++begin2)
+                ;
+            result = std::copy(begin1, end1, result);
+        });
+    return result;
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
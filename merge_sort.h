@@ -1,10 +1,17 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "sort.h"
+#include "sort_sampler.h"
+#include "sort_trace.h"
+#include "scratch.h"
+#include "deque_sort.detail.h"
 #include <cassert>
 #include <vector>
 #include <algorithm>        // inplace_merge
+#include <iterator>         // make_move_iterator
 
 namespace cdmh {
 
@@ -15,42 +22,125 @@ namespace cdmh {
 //  Worst case space complexity O(n) auxiliary
 // http://en.wikipedia.org/wiki/Mergesort
 
+namespace detail {
+
 // inplace merge sort
-template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void merge_sort(It begin, It end, Pred pred=Pred())
+template<typename It, typename Pred>
+CDMH_CONSTEXPR void merge_sort(It begin, It end, Pred pred)
 {
     auto const size = std::distance(begin, end);
     if (size <= 1)
         return;
+    detail::trace_span span(trace_event::sort, "merge_sort", size_t(size));
 
     It middle = begin;
     std::advance(middle, size / 2);
 
-    merge_sort(begin, middle, pred);
-    merge_sort(middle, end, pred);
+    detail::merge_sort(begin, middle, pred);
+    detail::merge_sort(middle, end, pred);
+
+    detail::trace_span merge(trace_event::merge, "merge", size_t(size));
     std::inplace_merge(begin, middle, end, pred);
 }
 
-// merge sort to non-overlapping output iterator
-template<typename It, typename Out, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void merge_sort_copy(It begin, It end, Out result, Pred pred=Pred())
+// merge sort that merges through a buffer holding the first half of each merge
+template<typename It, typename Pred, typename Buffer>
+CDMH_CONSTEXPR void merge_sort(It begin, It end, Pred &pred, Buffer &buffer)
 {
     auto const size = std::distance(begin, end);
-    if (size == 0)
-        return;
-    else if (size == 1)
-    {
-        *result++ = std::move(*begin);
+    if (size <= 1)
         return;
-    }
+    detail::trace_span span(trace_event::sort, "merge_sort", size_t(size));
 
     It middle = begin;
     std::advance(middle, size / 2);
 
-    std::vector<typename std::iterator_traits<It>::value_type> left, right;
-    merge_sort_copy(begin, middle, std::back_inserter(left), pred);
-    merge_sort_copy(middle, end, std::back_inserter(right), pred);
-    std::merge(left.begin(), left.end(), right.begin(), right.end(), result, pred);
+    detail::merge_sort(begin, middle, pred, buffer);
+    detail::merge_sort(middle, end, pred, buffer);
+
+    // once the buffer is empty, the rest of the second half is already in place
+    detail::trace_span merge(trace_event::merge, "merge", size_t(size));
+    buffer.assign(std::make_move_iterator(begin), std::make_move_iterator(middle));
+    auto first = buffer.begin();
+    for (It out=begin, second=middle; first!=buffer.end(); ++out)
+    {
+        if (second == end)
+        {
+            std::move(first, buffer.end(), out);
+            break;
+        }
+        else if (pred(*second, *first))
+            *out = std::move(*second++);
+        else
+            *out = std::move(*first++);
+    }
+}
+
+struct merge_sort_kernel
+{
+    template<typename It, typename Pred>
+    CDMH_CONSTEXPR void operator()(It begin, It end, Pred &pred) const
+    {
+        if (CDMH_CONSTANT_EVALUATED())
+        {
+            // std::inplace_merge is not constexpr, so at compile time merges use a buffer
+            std::vector<typename std::iterator_traits<It>::value_type> buffer;
+            detail::merge_sort(begin, end, pred, buffer);
+        }
+        else
+            detail::merge_sort(begin, end, pred);
+    }
+};
+
+// merge sort through a scratch buffer, which is reused for each block of a deque
+template<typename Buffer>
+struct merge_sort_buffer_kernel
+{
+    template<typename It, typename Pred>
+    CDMH_CONSTEXPR void operator()(It begin, It end, Pred &pred) const
+    {
+        detail::merge_sort(begin, end, pred, buffer);
+    }
+
+    Buffer &buffer;
+};
+
+}   // namespace detail
+
+// inplace merge sort
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+CDMH_CONSTEXPR void merge_sort(It begin, It end, Pred pred=Pred())
+{
+    detail::sample_scope<It, Pred> sample(sort_sample::merge_sort, begin, end, pred);
+    detail::sort_kernel(begin, end, pred, detail::merge_sort_kernel());
+}
+
+// merge sort with the scratch buffer allocated once from the given allocator
+template<typename It, typename Pred, typename Alloc>
+CDMH_CONSTEXPR void merge_sort(It begin, It end, Pred pred, Alloc const &alloc)
+{
+    detail::sample_scope<It, Pred> sample(sort_sample::merge_sort, begin, end, pred);
+    detail::scratch_vector<typename std::iterator_traits<It>::value_type, Alloc> buffer(alloc);
+    buffer.reserve(std::distance(begin, end) / 2);
+    detail::sort_kernel(begin, end, pred, detail::merge_sort_buffer_kernel<decltype(buffer)>{ buffer }, alloc);
+}
+
+// merge sort to non-overlapping output iterator. the elements are moved to a scratch
+// buffer and sorted there, with a second buffer for merging, then moved to the output
+template<typename It, typename Out, typename Pred, typename Alloc>
+inline void merge_sort_copy(It begin, It end, Out result, Pred pred, Alloc const &alloc)
+{
+    detail::scratch_vector<typename std::iterator_traits<It>::value_type, Alloc> values(alloc), buffer(alloc);
+    values.assign(std::make_move_iterator(begin), std::make_move_iterator(end));
+    buffer.reserve(values.size() / 2);
+    detail::merge_sort(values.data(), values.data() + values.size(), pred, buffer);
+    std::move(values.begin(), values.end(), result);
+}
+
+template<typename It, typename Out, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline void merge_sort_copy(It begin, It end, Out result, Pred pred=Pred())
+{
+    merge_sort_copy(begin, end, result, pred, std::allocator<typename std::iterator_traits<It>::value_type>());
 }
 
 }   // namespace cdmh
@@ -1,14 +1,18 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "sort.h"
 
 namespace cdmh {
 
 // MinMax Sort
 
-template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void minmax_sort(It begin, It end, Pred pred=Pred())
+namespace detail {
+
+template<typename It, typename Pred>
+inline void minmax_sort(It begin, It end, Pred pred)
 {
     auto count = std::distance(begin, end);
     for (auto it=begin, ite=end; count > 1; ++it, count-=2)
@@ -31,6 +35,15 @@ inline void minmax_sort(It begin, It end, Pred pred=Pred())
     }
 }
 
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline void minmax_sort(It begin, It end, Pred pred=Pred())
+{
+    auto const range = detail::kernel_range(begin, end);
+    detail::minmax_sort(range.first, range.second, pred);
+}
+
 }   // namespace cdmh
 
 // Permission is hereby granted, free of charge, to any person obtaining a copy
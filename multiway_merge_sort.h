@@ -0,0 +1,158 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "kway_merge.detail.h"
+#include "insertion_sort.h"
+#include "scratch.h"
+#include <algorithm>    // merge, min, max, move
+#include <iterator>     // make_move_iterator
+
+namespace cdmh {
+
+// Multiway Merge Sort
+//     Worst case performance       O(n log n)
+//     Average case performance     O(n log n)
+//     Worst case space complexity  O(n) auxiliary
+// http://en.wikipedia.org/wiki/External_sorting#External_merge_sort
+//
+// a stable merge sort for data much larger than the processor's caches. the range is
+// divided into blocks small enough to be sorted within the cache, which are sorted
+// with insertion sorts of short runs and merges of pairs of runs, and the sorted blocks
+// are then merged up to multiway_fan_in at a time with the tournament tree of losers
+// of the k-way merge, alternately from the range into a buffer and back. a binary
+// merge sort reads and writes all of the data once for each of the log2(n/block)
+// levels above the cache; with a fan-in of f this is log_f(n/block) passes, so with
+// the defaults 1e9 ints cross memory three times rather than thirteen. the number of
+// comparisons is the same, and a match in the tree costs more than a step of a binary
+// merge, so this pays only when memory bandwidth is the limit. the buffer of n
+// elements is allocated with the allocator given, and each block is moved into it to
+// be sorted, so the elements need not be default constructible. requires random
+// access iterators
+
+namespace detail {
+
+// bytes of data in each block sorted within the cache
+size_t const multiway_block_bytes = 1 << 20;
+
+// most sorted runs merged together in one pass
+size_t const multiway_fan_in = 64;
+
+// runs of this many elements are sorted with an insertion sort within a block
+size_t const multiway_leaf = 16;
+
+// stable sort of a block, with insertion sorts of short runs that are then merged in
+// pairs, a pass at a time, alternately from the block into the buffer and back
+template<typename Block, typename Buffer, typename Pred>
+inline void multiway_sort_block(Block begin, Block end, Buffer buffer, Pred &pred)
+{
+    size_t const size = end - begin;
+    for (size_t first=0; first<size; first+=multiway_leaf)
+        detail::insertion_sort(begin + first, begin + std::min(first + multiway_leaf, size), pred);
+
+    bool in_buffer = false;
+    for (size_t width=multiway_leaf; width<size; width*=2)
+    {
+        for (size_t first=0; first<size; first+=2*width)
+        {
+            size_t const middle = std::min(first + width, size);
+            size_t const last   = std::min(first + 2 * width, size);
+            if (in_buffer)
+            {
+                std::merge(
+                    std::make_move_iterator(buffer + first), std::make_move_iterator(buffer + middle),
+                    std::make_move_iterator(buffer + middle), std::make_move_iterator(buffer + last),
+                    begin + first, pred);
+            }
+            else
+            {
+                std::merge(
+                    std::make_move_iterator(begin + first), std::make_move_iterator(begin + middle),
+                    std::make_move_iterator(begin + middle), std::make_move_iterator(begin + last),
+                    buffer + first, pred);
+            }
+        }
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer)
+        std::move(buffer, buffer + size, begin);
+}
+
+// merge groups of up to multiway_fan_in adjacent runs of `from`, bounded by offsets,
+// into the same positions of `to`, and return the bounds of the merged runs
+template<typename From, typename To, typename Bounds, typename Pred, typename Alloc>
+inline Bounds multiway_merge_pass(From from, To to, Bounds const &bounds, Pred &pred, Alloc const &alloc)
+{
+    Bounds merged(1, 0, alloc);
+    scratch_vector<std::pair<From, From>, Alloc> runs(alloc);
+    for (size_t first=0; first+1<bounds.size(); first+=multiway_fan_in)
+    {
+        size_t const last = std::min(first + multiway_fan_in, bounds.size() - 1);
+        runs.clear();
+        for (size_t run=first; run<last; ++run)
+            runs.push_back(std::make_pair(from + bounds[run], from + bounds[run + 1]));
+        detail::kway_merge<true>(runs, to + bounds[first], pred, alloc);
+        merged.push_back(bounds[last]);
+    }
+    return merged;
+}
+
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void multiway_merge_sort(It begin, It end, Pred pred=Pred(), Alloc const &alloc=Alloc())
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+    size_t const size  = std::distance(begin, end);
+    size_t const block = std::max<size_t>(detail::multiway_block_bytes / sizeof(value_type), 16);
+    auto const range = detail::kernel_range(begin, end);
+
+    // move each block into the buffer and sort it there, through its place in the range
+    detail::scratch_vector<value_type, Alloc> data(alloc);
+    data.reserve(size);
+    detail::scratch_vector<size_t, Alloc> bounds(1, 0, alloc);
+    for (size_t first=0; first<size; first+=block)
+    {
+        size_t const last = std::min(first + block, size);
+        data.insert(data.end(), std::make_move_iterator(range.first + first), std::make_move_iterator(range.first + last));
+        detail::multiway_sort_block(data.data() + first, data.data() + last, range.first + first, pred);
+        bounds.push_back(last);
+    }
+
+    // merge the sorted blocks, moving the elements between the buffer and the range
+    bool in_buffer = true;
+    while (bounds.size() > 2)
+    {
+        if (in_buffer)
+            bounds = detail::multiway_merge_pass(data.data(), range.first, bounds, pred, alloc);
+        else
+            bounds = detail::multiway_merge_pass(range.first, data.data(), bounds, pred, alloc);
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer)
+        std::move(data.begin(), data.end(), range.first);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
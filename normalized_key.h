@@ -0,0 +1,366 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "block_merge_sort.h"
+#include "insertion_sort.h"
+#include "scratch.h"
+#include <algorithm>    // copy, min
+#include <cmath>        // isnan
+#include <cstdint>
+#include <cstring>      // memcmp, memcpy
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cdmh {
+
+// Normalised Key Sort
+//     Worst case performance       O(n w) for keys of w bytes, O(n log n) for ties in the first 8
+//     Worst case space complexity  O(n w) auxiliary
+//
+// a key_encoder encodes the columns of a composite key, such as (tenant asc,
+// timestamp desc, name asc), into a byte string that orders the keys as memcmp
+// orders the bytes, so one comparison replaces a comparator with a branch for each
+// column. integers are big-endian with the sign bit flipped, floating point values
+// have the sign bit flipped or all bits inverted, with -0 encoded as 0 and NaNs after
+// infinity, and strings are compared bytewise, with each zero byte escaped as 00 ff
+// and a terminator of 00 00, so a string orders before any longer string it begins.
+// a descending column has the bytes of its encoding inverted. a nullable column
+// starts with a byte that orders nulls first or last in either direction. the first
+// 8 bytes of a key, big-endian, are its uint64 prefix.
+// sort_by_normalized_key encodes the key of each element once, radix sorts the
+// prefixes, skipping the bytes in which all the prefixes agree, and sorts each run of
+// equal prefixes by the 8 bytes after, and so on, then moves the elements into order.
+// the sort is stable. sort_by_key_prefix keeps only the prefix of each key, and breaks
+// ties between equal prefixes with a comparator of the elements, so it suits keys
+// that are long but mostly differ early. scratch memory is allocated with the
+// allocator given. requires random access iterators
+
+enum class sort_order { ascending, descending };
+enum class null_order { nulls_first, nulls_last };
+
+class key_encoder
+{
+  public:
+    void clear()
+    {
+        bytes_.clear();
+    }
+
+    // integers of any width
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value, key_encoder &>::type add(T value, sort_order order=sort_order::ascending)
+    {
+        using unsigned_type = typename std::make_unsigned<T>::type;
+        std::uint64_t bits = unsigned_type(value);
+        if (std::is_signed<T>::value)
+            bits ^= std::uint64_t(1) << (8 * sizeof(T) - 1);
+        return add_big_endian(bits, sizeof(T), order);
+    }
+
+    key_encoder &add(double value, sort_order order=sort_order::ascending)
+    {
+        std::uint64_t bits = 0x7ff8000000000000;
+        if (!std::isnan(value))
+        {
+            value += 0.0;   // -0 becomes 0
+            std::memcpy(&bits, &value, sizeof(bits));
+        }
+        bits = (bits >> 63)? ~bits : bits | (std::uint64_t(1) << 63);
+        return add_big_endian(bits, sizeof(bits), order);
+    }
+
+    key_encoder &add(float value, sort_order order=sort_order::ascending)
+    {
+        std::uint32_t bits = 0x7fc00000;
+        if (!std::isnan(value))
+        {
+            value += 0.0f;
+            std::memcpy(&bits, &value, sizeof(bits));
+        }
+        bits = (bits >> 31)? ~bits : bits | (std::uint32_t(1) << 31);
+        return add_big_endian(bits, sizeof(bits), order);
+    }
+
+    // strings, ordered bytewise as unsigned chars
+    key_encoder &add(char const *data, size_t size, sort_order order=sort_order::ascending)
+    {
+        unsigned char const invert = (order == sort_order::descending)? 0xff : 0x00;
+        for (size_t loop=0; loop<size; ++loop)
+        {
+            unsigned char const byte = static_cast<unsigned char>(data[loop]);
+            bytes_.push_back(byte ^ invert);
+            if (byte == 0)
+                bytes_.push_back(0xff ^ invert);
+        }
+        bytes_.push_back(invert);
+        bytes_.push_back(invert);
+        return *this;
+    }
+
+    key_encoder &add(std::string const &value, sort_order order=sort_order::ascending)
+    {
+        return add(value.data(), value.size(), order);
+    }
+
+    key_encoder &add(char const *value, sort_order order=sort_order::ascending)
+    {
+        return add(value, std::strlen(value), order);
+    }
+
+    // a nullable column is null, or has its value added after not_null(). the same
+    // null_order must be used for the column in every key
+    key_encoder &null(null_order nulls=null_order::nulls_first)
+    {
+        bytes_.push_back((nulls == null_order::nulls_first)? 0x00 : 0x02);
+        return *this;
+    }
+
+    key_encoder &not_null()
+    {
+        bytes_.push_back(0x01);
+        return *this;
+    }
+
+    unsigned char const *data() const
+    {
+        return bytes_.data();
+    }
+
+    size_t size() const
+    {
+        return bytes_.size();
+    }
+
+    std::string str() const
+    {
+        return std::string(bytes_.begin(), bytes_.end());
+    }
+
+    // the first 8 bytes of the key, big-endian, padded with zeros
+    std::uint64_t prefix() const
+    {
+        return key_prefix(bytes_.data(), bytes_.size());
+    }
+
+    static std::uint64_t key_prefix(unsigned char const *data, size_t size)
+    {
+        std::uint64_t prefix = 0;
+        for (size_t loop=0; loop<8; ++loop)
+            prefix = (prefix << 8) | ((loop < size)? data[loop] : 0);
+        return prefix;
+    }
+
+    // <0, 0 or >0 as the first key orders before, with or after the second
+    static int compare(unsigned char const *first, size_t first_size, unsigned char const *second, size_t second_size)
+    {
+        int const result = std::memcmp(first, second, std::min(first_size, second_size));
+        if (result != 0)
+            return result;
+        return (first_size < second_size)? -1 : (second_size < first_size)? 1 : 0;
+    }
+
+  private:
+    key_encoder &add_big_endian(std::uint64_t bits, size_t size, sort_order order)
+    {
+        if (order == sort_order::descending)
+            bits = ~bits;
+        for (size_t loop=size; loop-- > 0; )
+            bytes_.push_back(static_cast<unsigned char>(bits >> (8 * loop)));
+        return *this;
+    }
+
+    std::vector<unsigned char> bytes_;
+};
+
+namespace detail {
+
+// the encoded key of an element, by its prefix and its place in the key arena
+struct normalized_key
+{
+    std::uint64_t prefix;
+    size_t        offset;
+    size_t        size;
+    size_t        index;    // of the element in the range
+};
+
+// runs of keys this short are sorted with an insertion sort of the rest of the keys
+size_t const normalized_key_insertion_max = 32;
+
+// stable LSD radix sort of the keys by prefix, a byte at a time, with the histograms
+// of all 8 bytes counted in one pass and the bytes in which the prefixes agree skipped
+inline void radix_sort_prefixes(normalized_key *begin, normalized_key *end, normalized_key *buffer)
+{
+    size_t counts[8][256] = { };
+    for (auto key=begin; key!=end; ++key)
+    {
+        for (size_t byte=0; byte<8; ++byte)
+            ++counts[byte][(key->prefix >> (8 * byte)) & 0xff];
+    }
+
+    size_t const size = end - begin;
+    normalized_key *from = begin;
+    normalized_key *to   = buffer;
+    for (size_t byte=0; byte<8; ++byte)
+    {
+        auto &count = counts[byte];
+        if (count[(begin->prefix >> (8 * byte)) & 0xff] == size)
+            continue;
+
+        size_t position = 0;
+        for (auto &bucket : count)
+        {
+            size_t const bucket_size = bucket;
+            bucket = position;
+            position += bucket_size;
+        }
+        for (auto key=from; key!=from+size; ++key)
+            to[count[(key->prefix >> (8 * byte)) & 0xff]++] = *key;
+        std::swap(from, to);
+    }
+    if (from != begin)
+        std::copy(from, from + size, begin);
+}
+
+// stable sort of keys whose first `depth` bytes are equal, by the rest of their bytes.
+// the keys are radix sorted by their next 8 bytes, and each run that has equal bytes
+// there is sorted in turn by the 8 after, so the arena is read 8 bytes at a time
+inline void sort_normalized_keys(normalized_key *begin, normalized_key *end, normalized_key *buffer, unsigned char const *bytes, size_t depth)
+{
+    auto const rest = [bytes, depth](normalized_key const &first, normalized_key const &second) {
+        size_t const first_size  = (first.size > depth)? first.size - depth : 0;
+        size_t const second_size = (second.size > depth)? second.size - depth : 0;
+        return key_encoder::compare(bytes + first.offset + depth, first_size, bytes + second.offset + depth, second_size) < 0;
+    };
+    if (size_t(end - begin) <= normalized_key_insertion_max)
+    {
+        detail::insertion_sort(begin, end, rest);
+        return;
+    }
+
+    for (auto key=begin; key!=end; ++key)
+        key->prefix = (key->size > depth)? key_encoder::key_prefix(bytes + key->offset + depth, key->size - depth) : 0;
+    detail::radix_sort_prefixes(begin, end, buffer);
+
+    for (normalized_key *run=begin, *run_end; run!=end; run=run_end)
+    {
+        bool longer = run->size > depth + 8;
+        bool sizes  = false;
+        for (run_end=run+1; run_end!=end  &&  run_end->prefix == run->prefix; ++run_end)
+        {
+            longer = longer  ||  run_end->size > depth + 8;
+            sizes  = sizes  ||  run_end->size != run->size;
+        }
+
+        // keys that end within these 8 bytes and match them are equal, or one is the
+        // other followed by zeros, which orders after it
+        if (longer)
+            detail::sort_normalized_keys(run, run_end, buffer, bytes, depth + 8);
+        else if (sizes)
+            cdmh::block_merge_sort(run, run_end, rest);
+    }
+}
+
+// move the elements of the range into the order of the sorted keys
+template<typename It, typename Keys, typename Alloc>
+inline void apply_key_order(It begin, Keys const &keys, Alloc const &alloc)
+{
+    detail::scratch_vector<typename std::iterator_traits<It>::value_type, Alloc> values(alloc);
+    values.reserve(keys.size());
+    for (auto const &key : keys)
+        values.push_back(std::move(begin[key.index]));
+    std::move(values.begin(), values.end(), begin);
+}
+
+}   // namespace detail
+
+// stable sort by the normalised key that encode(element, encoder) adds to the encoder
+template<typename It, typename Encode, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void sort_by_normalized_key(It begin, It end, Encode encode, Alloc const &alloc=Alloc())
+{
+    size_t const size = std::distance(begin, end);
+    if (size <= 1)
+        return;
+    auto const range = detail::kernel_range(begin, end);
+
+    detail::scratch_vector<unsigned char, Alloc> arena(alloc);
+    detail::scratch_vector<detail::normalized_key, Alloc> keys(alloc), buffer(alloc);
+    keys.reserve(size);
+    key_encoder encoder;
+    for (size_t index=0; index<size; ++index)
+    {
+        encoder.clear();
+        encode(range.first[index], encoder);
+        detail::normalized_key const key = { 0, arena.size(), encoder.size(), index };
+        keys.push_back(key);
+        arena.insert(arena.end(), encoder.data(), encoder.data() + encoder.size());
+    }
+
+    buffer.resize(size);
+    detail::sort_normalized_keys(keys.data(), keys.data() + size, buffer.data(), arena.data(), 0);
+    detail::apply_key_order(range.first, keys, alloc);
+}
+
+// stable sort by the uint64 prefix of the normalised key of each element, breaking
+// ties between equal prefixes with pred, which must order the elements as the full keys do
+template<typename It, typename Encode, typename Pred, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void sort_by_key_prefix(It begin, It end, Encode encode, Pred pred, Alloc const &alloc=Alloc())
+{
+    size_t const size = std::distance(begin, end);
+    if (size <= 1)
+        return;
+    auto const range = detail::kernel_range(begin, end);
+
+    detail::scratch_vector<detail::normalized_key, Alloc> keys(alloc), buffer(alloc);
+    keys.reserve(size);
+    key_encoder encoder;
+    for (size_t index=0; index<size; ++index)
+    {
+        encoder.clear();
+        encode(range.first[index], encoder);
+        detail::normalized_key const key = { encoder.prefix(), 0, encoder.size(), index };
+        keys.push_back(key);
+    }
+
+    buffer.resize(size);
+    detail::radix_sort_prefixes(keys.data(), keys.data() + size, buffer.data());
+
+    // the keys of each run of equal prefixes are in their original order, which a
+    // stable sort by pred keeps for equal elements
+    auto const elements = range.first;
+    for (auto run=keys.begin(), run_end=run; run!=keys.end(); run=run_end)
+    {
+        for (run_end=run+1; run_end!=keys.end()  &&  run_end->prefix == run->prefix; ++run_end)
+            ;
+        if (run_end - run > 1)
+        {
+            cdmh::block_merge_sort(run, run_end, [elements, &pred](detail::normalized_key const &first, detail::normalized_key const &second) {
+                return pred(elements[first.index], elements[second.index]);
+            });
+        }
+    }
+    detail::apply_key_order(range.first, keys, alloc);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
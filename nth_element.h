@@ -0,0 +1,144 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "insertion_sort.h"
+#include "quicksort.detail.h"
+#include <cmath>    // floor, log
+
+namespace cdmh {
+
+// Nth Element (Introselect)
+//     Worst case performance       O(n)
+//     Best case performance        O(n)
+//     Average case performance     O(n)
+//     Worst case space complexity  O(1) auxiliary
+// http://en.wikipedia.org/wiki/Introselect
+//
+// rearranges the range so that the element at `nth` is the one that would be there
+// if the range were sorted, with no element before it greater and no element after
+// it less. quickselect partitions with quicksort_splits, and keeps only the side
+// holding `nth`. if two partitions in a row fail to halve the range, or there are
+// too many partitions, then the pivot is chosen by median of medians from then on,
+// which guarantees linear time. unlike std::nth_element, bidirectional iterators are
+// sufficient
+
+namespace detail {
+
+// ranges of this size or smaller are finished with an insertion sort
+size_t const nth_element_threshold = 16;
+
+template<typename It, typename Pred>
+inline void nth_element(It begin, size_t nth, It end, Pred pred, size_t depth);
+
+// choose a pivot that is guaranteed to have at least 3/10 of the range on either side.
+// the median of each group of five elements is moved to the front of the range, and
+// the median of those medians is then selected recursively
+template<typename It, typename Pred>
+inline typename std::iterator_traits<It>::value_type median_of_medians(It begin, It end, Pred pred)
+{
+    auto   medians_end = begin;
+    size_t medians     = 0;
+    for (auto it=begin; it!=end; ++medians)
+    {
+        auto   group_end = it;
+        size_t count     = 0;
+        for (; count < 5  &&  group_end != end; ++count)
+            ++group_end;
+
+        cdmh::insertion_sort(it, group_end, pred);
+        std::iter_swap(medians_end++, detail::advance(it, count / 2));
+        it = group_end;
+    }
+
+    // a depth of zero selects the median of the medians by median of medians
+    detail::nth_element(begin, medians / 2, medians_end, pred, 0);
+    return *detail::advance(begin, medians / 2);
+}
+
+template<typename It, typename Pred>
+inline void nth_element(It begin, size_t nth, It end, Pred pred, size_t depth)
+{
+    size_t checkpoint = std::distance(begin, end);
+    size_t partitions = 0;
+    for (auto size=checkpoint; size > nth_element_threshold; )
+    {
+        // the quickselect partitions must halve the range every two partitions for the
+        // time to stay linear
+        if (partitions == 2)
+        {
+            if (size > checkpoint / 2)
+                depth = 0;
+            checkpoint = size;
+            partitions = 0;
+        }
+
+        std::pair<It,It> splits;
+        if (depth == 0)
+            splits = detail::partition_around(begin, end, detail::median_of_medians(begin, end, pred), pred);
+        else
+        {
+            --depth;
+            ++partitions;
+            splits = detail::quicksort_splits(begin, end, pred);
+        }
+
+        size_t const less  = std::distance(begin, splits.first);
+        size_t const equal = std::distance(splits.first, splits.second);
+        if (nth < less)
+        {
+            end  = splits.first;
+            size = less;
+        }
+        else if (nth < less + equal)
+            return;
+        else
+        {
+            begin = splits.second;
+            nth  -= less + equal;
+            size -= less + equal;
+        }
+    }
+    cdmh::insertion_sort(begin, end, pred);
+}
+
+// quickselect may make this many partitions before switching to median of medians
+inline size_t introselect_depth(size_t size)
+{
+    return 2 * (size_t)floor(log(double(size)) / log(2.0)) + 1;
+}
+
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline void nth_element(It begin, It nth, It end, Pred pred=Pred())
+{
+    auto const size = std::distance(begin, end);
+    if (size > 1  &&  nth != end)
+    {
+        auto const range = detail::kernel_range(begin, end);
+        detail::nth_element(range.first, std::distance(begin, nth), range.second, pred, detail::introselect_depth(size));
+    }
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,98 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "sort_sampler.h"
+#include "sort_trace.h"
+#include "introsort.h"
+#include "kway_merge.detail.h"
+#include "scratch.h"
+#include <iterator>     // make_move_iterator
+
+namespace cdmh {
+
+// Parallel Sort
+//     Worst case performance       O((n/p) log n + (n/p) log p)
+//     Average case performance     O((n/p) log n + (n/p) log p)
+//     Worst case space complexity  O(n) auxiliary
+//
+// the range is moved into a buffer, cut into one part per thread, and each part is
+// sorted with introsort on its own thread. the sorted parts are then moved back into
+// the range by a parallel k-way merge. the buffer is move constructed, so the
+// elements need not be default constructible. ranges too small to be worth dividing
+// are sorted with introsort on the calling thread. the buffer is allocated with the
+// allocator given, on the calling thread. requires random access iterators
+
+namespace detail {
+
+// smallest number of elements worth sorting on a thread of its own
+size_t const parallel_sort_min_part = 1 << 14;
+
+template<typename It, typename Pred, typename Alloc>
+inline void parallel_sort(It begin, It end, Pred pred, unsigned threads, Alloc const &alloc)
+{
+    auto const size  = std::distance(begin, end);
+    auto const parts = std::min<size_t>(threads, size / detail::parallel_sort_min_part);
+    detail::trace_span span(trace_event::sort, "parallel_sort", size_t(size));
+    if (parts <= 1)
+    {
+        cdmh::introsort(begin, end, pred);
+        return;
+    }
+
+    using value_type = typename std::iterator_traits<It>::value_type;
+    detail::scratch_vector<value_type, Alloc> buffer(alloc);
+    buffer.reserve(size);
+    buffer.insert(buffer.end(), std::make_move_iterator(begin), std::make_move_iterator(end));
+
+    detail::scratch_vector<std::pair<value_type *, value_type *>, Alloc> runs(alloc);
+    runs.reserve(parts);
+    for (size_t part=0; part<parts; ++part)
+        runs.push_back(std::make_pair(buffer.data() + size * part / parts, buffer.data() + size * (part + 1) / parts));
+
+    detail::scratch_vector<std::thread, Alloc> workers(alloc);
+    workers.reserve(parts);
+    for (auto const &run : runs)
+    {
+        workers.emplace_back([run, &pred]() {
+            detail::nested_sample_scope nested;
+            cdmh::introsort(run.first, run.second, pred);
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    detail::parallel_kway_merge<true>(runs, begin, pred, parts, alloc);
+}
+
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void parallel_sort(It begin, It end, Pred pred=Pred(), unsigned threads=std::thread::hardware_concurrency(), Alloc const &alloc=Alloc())
+{
+    detail::sample_scope<It, Pred> sample(sort_sample::parallel_sort, begin, end, pred);
+    auto const range = detail::kernel_range(begin, end);
+    detail::parallel_sort(range.first, range.second, pred, threads, alloc);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
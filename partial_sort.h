@@ -0,0 +1,62 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "introsort.h"
+#include "nth_element.h"
+
+namespace cdmh {
+
+// Partial Sort
+//     Worst case performance       O(n + k log k)
+//     Average case performance     O(n + k log k)
+//     Worst case space complexity  O(log k) auxiliary
+// http://en.wikipedia.org/wiki/Partial_sorting
+//
+// sorts the k = middle - begin elements that come first in the order into
+// [begin, middle), leaving the rest of the elements in [middle, end) in no particular
+// order. the first k elements are selected with nth_element and then sorted with
+// introsort, rather than with a heap of size k as std::partial_sort does, so
+// bidirectional iterators are sufficient
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline void partial_sort(It begin, It middle, It end, Pred pred=Pred())
+{
+    if (begin == middle)
+        return;
+
+    cdmh::nth_element(begin, middle, end, pred);
+    cdmh::introsort(begin, middle, pred);
+}
+
+// sort the first `k` elements in the order to the front of the range, returning
+// the end of the sorted prefix
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline It top_k(It begin, It end, size_t k, Pred pred=Pred())
+{
+    auto const middle = detail::advance(begin, std::min<size_t>(k, std::distance(begin, end)));
+    cdmh::partial_sort(begin, middle, end, pred);
+    return middle;
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,175 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__linux__)
+#include <cstring>      // memset
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace cdmh {
+
+// Hardware Performance Counters
+//
+// reads the processor's counters of cycles, instructions, branch mispredictions and
+// L1 data, last level cache and data TLB misses around a piece of code, through the
+// Linux perf_event_open interface. each counter is opened on its own, so a counter
+// the processor or kernel does not support is simply unavailable while the others
+// still count; in a container or on another operating system usually none are
+// available, which the caller can test with available(). the counters include
+// threads started by the calling thread while they are running, and counts are
+// scaled up if the kernel had to share the hardware counters between events
+
+class perf_counters
+{
+  public:
+    enum counter { cycles, instructions, branch_misses, l1d_misses, llc_misses, dtlb_misses, counter_count };
+
+    perf_counters()
+    {
+        for (int c=0; c<counter_count; ++c)
+        {
+            fds_[c]    = -1;
+            values_[c] = 0;
+        }
+#if defined(__linux__)
+        auto const cache_miss = [](std::uint64_t cache) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        fds_[cycles]        = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds_[instructions]  = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds_[branch_misses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds_[l1d_misses]    = open(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D));
+        fds_[llc_misses]    = open(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL));
+        fds_[dtlb_misses]   = open(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB));
+#endif
+    }
+
+    ~perf_counters()
+    {
+#if defined(__linux__)
+        for (int c=0; c<counter_count; ++c)
+        {
+            if (fds_[c] != -1)
+                ::close(fds_[c]);
+        }
+#endif
+    }
+
+    // true if any counter can be read
+    bool available() const
+    {
+        for (int c=0; c<counter_count; ++c)
+        {
+            if (available(counter(c)))
+                return true;
+        }
+        return false;
+    }
+
+    bool available(counter c) const
+    {
+        return fds_[c] != -1;
+    }
+
+    // reset and start the counters
+    void start()
+    {
+#if defined(__linux__)
+        for (int c=0; c<counter_count; ++c)
+        {
+            if (fds_[c] != -1)
+            {
+                ::ioctl(fds_[c], PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(fds_[c], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // stop the counters and read the counts since start()
+    void stop()
+    {
+#if defined(__linux__)
+        for (int c=0; c<counter_count; ++c)
+        {
+            if (fds_[c] != -1)
+                ::ioctl(fds_[c], PERF_EVENT_IOC_DISABLE, 0);
+        }
+
+        // the value, and the times the event was enabled and actually counting
+        for (int c=0; c<counter_count; ++c)
+        {
+            std::uint64_t data[3] = { 0, 0, 0 };
+            values_[c] = 0;
+            if (fds_[c] != -1  &&  ::read(fds_[c], data, sizeof(data)) == sizeof(data)  &&  data[2] != 0)
+                values_[c] = std::uint64_t(double(data[0]) * double(data[1]) / double(data[2]));
+        }
+#endif
+    }
+
+    // the count between the last start() and stop()
+    std::uint64_t value(counter c) const
+    {
+        return values_[c];
+    }
+
+    static char const *name(counter c)
+    {
+        static char const *const names[] = {
+            "cycles", "instructions", "branch-misses", "L1-dcache-load-misses", "LLC-load-misses", "dTLB-load-misses"
+        };
+        return names[c];
+    }
+
+  private:
+    perf_counters(perf_counters const &);
+    perf_counters &operator=(perf_counters const &);
+
+#if defined(__linux__)
+    // a counter of user space events for this thread and the threads it starts
+    static int open(std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.inherit        = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return int(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    int           fds_[counter_count];
+    std::uint64_t values_[counter_count];
+};
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
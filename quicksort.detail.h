@@ -3,40 +3,54 @@
 
 #pragma once
 
+#include "sort.h"
+#include "sort_trace.h"
+#include <algorithm>    // partition
+
 namespace cdmh {
 
 namespace detail {
 
-template<typename T>
-inline T median(T const &t1, T const &t2, T const &t3)
+template<typename T, typename Pred>
+CDMH_CONSTEXPR T median(T const &t1, T const &t2, T const &t3, Pred pred)
 {
-    if (t1 < t2)
+    if (pred(t1, t2))
     {
-        if (t2 < t3)
+        if (pred(t2, t3))
             return t2;
-        else if (t1 < t3)
+        else if (pred(t1, t3))
             return t3;
         else
             return t1;
     }
-    else if (t1 < t3)
+    else if (pred(t1, t3))
         return t1;
-    else if (t2 < t3)
+    else if (pred(t2, t3))
         return t3;
     else
         return t2;
 }
 
-template<typename It, typename Pred>
-inline std::pair<It,It> quicksort_splits(It begin, It end, Pred pred)
+// three-way partition around a pivot value, returning the bounds of the elements
+// equivalent to the pivot; [begin, first) are less and [second, end) are greater
+template<typename It, typename T, typename Pred>
+CDMH_CONSTEXPR std::pair<It,It> partition_around(It begin, It end, T const &pivot, Pred pred)
 {
     using value_t = typename std::iterator_traits<It>::value_type;
     using namespace std::placeholders;
 
     auto const not_pred = [&pred](value_t const &first, value_t const &second) { return !pred(second, first); };
-    auto const pivot    = detail::median(*begin, *detail::advance(begin, std::distance(begin, end) / 2), *detail::advance(end, -1));
-    auto const split    = std::partition(begin, end, std::bind(pred, _1, pivot));
-    return std::make_pair(split, std::partition(split, end, std::bind(not_pred, _1, pivot)));
+    auto const split    = std::partition(begin, end, std::bind(pred, _1, std::cref(pivot)));
+    return std::make_pair(split, std::partition(split, end, std::bind(not_pred, _1, std::cref(pivot))));
+}
+
+template<typename It, typename Pred>
+CDMH_CONSTEXPR std::pair<It,It> quicksort_splits(It begin, It end, Pred pred)
+{
+    auto const size = std::distance(begin, end);
+    detail::trace_span span(trace_event::partition, "partition", size_t(size));
+    auto const pivot = detail::median(*begin, *detail::advance(begin, size / 2), *detail::advance(end, -1), pred);
+    return detail::partition_around(begin, end, pivot, pred);
 }
 
 }   // namespace detail
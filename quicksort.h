@@ -1,7 +1,10 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "sort.h"
+#include "sort_sampler.h"
 #include "quicksort.detail.h"
 
 namespace cdmh {
@@ -13,17 +16,31 @@ namespace cdmh {
 //     Worst case space complexity  O(n) auxiliary (naive) O(log n) auxiliary (Sedgewick 1978)
 // http://en.wikipedia.org/wiki/Quicksort
 
-template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void quicksort(It begin, It end, Pred pred=Pred())
+namespace detail {
+
+template<typename It, typename Pred>
+CDMH_CONSTEXPR void quicksort(It begin, It end, Pred pred)
 {
-    if (std::distance(begin, end) > 1)
+    auto const size = std::distance(begin, end);
+    if (size > 1)
     {
+        detail::trace_span span(trace_event::sort, "quicksort", size_t(size));
         auto splits = detail::quicksort_splits(begin, end, pred);
-        quicksort(begin, splits.first, pred);
-        quicksort(splits.second, end, pred);
+        detail::quicksort(begin, splits.first, pred);
+        detail::quicksort(splits.second, end, pred);
     }
 }
 
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+CDMH_CONSTEXPR void quicksort(It begin, It end, Pred pred=Pred())
+{
+    detail::sample_scope<It, Pred> sample(sort_sample::quicksort, begin, end, pred);
+    auto const range = detail::kernel_range(begin, end);
+    detail::quicksort(range.first, range.second, pred);
+}
+
 }   // namespace cdmh
 
 // Permission is hereby granted, free of charge, to any person obtaining a copy
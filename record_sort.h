@@ -0,0 +1,235 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include <cerrno>
+#include <cstring>      // memcmp, memcpy
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cdmh {
+
+// Fixed-width binary record sort
+//
+// sorts a file of fixed-width binary records in place through a shared memory map
+// of the file, so the records are never read into, or written back from, a copy.
+// when the record size is known at compile time the records are viewed as an array
+// of record<Size> and any of the sort algorithms can be applied directly to the
+// mapping. other record sizes are sorted by index, and the index is then applied
+// to the mapping with a cycle-following permutation.
+// keys are compared as unsigned bytes, so big-endian integers and strings sort naturally
+
+template<size_t Size>
+struct record
+{
+    unsigned char bytes[Size];
+};
+
+// orders records by the bytes [offset, offset+length) of each record
+struct record_key_less
+{
+    record_key_less(size_t offset, size_t length) : offset(offset), length(length)
+    {
+    }
+
+    bool operator()(unsigned char const *first, unsigned char const *second) const
+    {
+        return std::memcmp(first + offset, second + offset, length) < 0;
+    }
+
+    template<size_t Size>
+    bool operator()(record<Size> const &first, record<Size> const &second) const
+    {
+        return (*this)(first.bytes, second.bytes);
+    }
+
+    size_t offset;
+    size_t length;
+};
+
+// read/write shared memory map of a whole file. transparent huge pages are requested
+// where the platform supports them, before any page is touched, and the mapping is
+// then populated up front
+class mapped_file
+{
+  public:
+    explicit mapped_file(std::string const &path)
+      : fd_(::open(path.c_str(), O_RDWR)),
+        data_(nullptr),
+        size_(0)
+    {
+        if (fd_ == -1)
+            throw std::system_error(errno, std::system_category(), "open " + path);
+
+        struct stat st;
+        if (::fstat(fd_, &st) == -1)
+            fail("fstat " + path);
+        size_ = st.st_size;
+        if (size_ == 0)
+            return;
+
+        void *data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (data == MAP_FAILED)
+            fail("mmap " + path);
+        data_ = static_cast<unsigned char *>(data);
+
+#ifdef MADV_HUGEPAGE
+        ::madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+        ::madvise(data_, size_, MADV_WILLNEED);
+        populate();
+    }
+
+    ~mapped_file()
+    {
+        if (data_)
+            ::munmap(data_, size_);
+        ::close(fd_);
+    }
+
+    unsigned char *data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+  private:
+    // fault in every page of the mapping for writing, or failing that for reading
+    void populate()
+    {
+#ifdef MADV_POPULATE_WRITE
+        if (::madvise(data_, size_, MADV_POPULATE_WRITE) == 0)
+            return;
+#endif
+        size_t const page = size_t(::sysconf(_SC_PAGESIZE));
+        unsigned char volatile const *bytes = data_;
+        for (size_t offset=0; offset<size_; offset+=page)
+            bytes[offset];
+    }
+
+    mapped_file(mapped_file const &);
+    mapped_file &operator=(mapped_file const &);
+
+    void fail(std::string const &what)
+    {
+        auto const error = errno;
+        ::close(fd_);
+        throw std::system_error(error, std::system_category(), what);
+    }
+
+    int            fd_;
+    unsigned char *data_;
+    size_t         size_;
+};
+
+namespace detail {
+
+inline void check_record_layout(size_t file_size, size_t record_size, size_t key_offset, size_t key_length)
+{
+    if (record_size == 0  ||  file_size % record_size != 0)
+        throw std::invalid_argument("file size is not a multiple of the record size");
+    if (key_offset + key_length > record_size)
+        throw std::invalid_argument("key extends beyond the end of the record");
+}
+
+// rearrange records so that the record at index order[i] moves to index i,
+// following each cycle of the permutation with a single record of temporary storage
+inline void permute_records(unsigned char *data, size_t record_size, std::vector<size_t> &order)
+{
+    std::vector<unsigned char> temp(record_size);
+    for (size_t start=0; start<order.size(); ++start)
+    {
+        if (order[start] == start)
+            continue;
+
+        std::memcpy(temp.data(), data + start * record_size, record_size);
+        auto hole = start;
+        while (order[hole] != start)
+        {
+            auto const next = order[hole];
+            std::memcpy(data + hole * record_size, data + next * record_size, record_size);
+            order[hole] = hole;
+            hole = next;
+        }
+        std::memcpy(data + hole * record_size, temp.data(), record_size);
+        order[hole] = hole;
+    }
+}
+
+}   // namespace detail
+
+// sort records of a compile time size in place. `sort` is any of the sort algorithms,
+// and is called with record<Size> pointers and a record_key_less predicate
+template<size_t Size, typename Sort>
+inline void sort_records(unsigned char *data, size_t size, size_t key_offset, size_t key_length, Sort sort)
+{
+    detail::check_record_layout(size, Size, key_offset, key_length);
+    auto const begin = reinterpret_cast<record<Size> *>(data);
+    sort(begin, begin + size / Size, record_key_less(key_offset, key_length));
+}
+
+// sort records of a run time size. `sort` is called with size_t pointers to an
+// index of the records, and a predicate that compares the keys of indexed records,
+// so must be a function object with a templated function call operator
+template<typename Sort>
+inline void sort_records(unsigned char *data, size_t size, size_t record_size, size_t key_offset, size_t key_length, Sort sort)
+{
+    detail::check_record_layout(size, record_size, key_offset, key_length);
+
+    std::vector<size_t> order(size / record_size);
+    for (size_t loop=0; loop<order.size(); ++loop)
+        order[loop] = loop;
+
+    record_key_less const less(key_offset, key_length);
+    sort(order.data(), order.data() + order.size(), [data, record_size, &less](size_t first, size_t second) {
+        return less(data + first * record_size, data + second * record_size);
+    });
+    detail::permute_records(data, record_size, order);
+}
+
+template<size_t Size, typename Sort>
+inline void sort_mapped_file(std::string const &path, size_t key_offset, size_t key_length, Sort sort)
+{
+    mapped_file file(path);
+    sort_records<Size>(file.data(), file.size(), key_offset, key_length, sort);
+}
+
+template<typename Sort>
+inline void sort_mapped_file(std::string const &path, size_t record_size, size_t key_offset, size_t key_length, Sort sort)
+{
+    mapped_file file(path);
+    sort_records(file.data(), file.size(), record_size, key_offset, key_length, sort);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
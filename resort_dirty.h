@@ -0,0 +1,153 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "insertion_sort.h"
+#include "introsort.h"
+#include "merge_sort.h"
+#include "scratch.h"
+#include "sorted_buffer.h"  // gallop_upper_bound
+#include <algorithm>        // is_sorted, move_backward, rotate, unique
+#include <cassert>
+#include <iterator>         // begin, end
+
+namespace cdmh {
+
+// Resort Dirty
+//     Worst case performance       O(n + k log k) for k modified elements
+//     Best case performance        O(k log n) comparisons and O(d) moves for k <= 8
+//     Worst case space complexity  O(k) auxiliary
+//
+// restores the order of a sorted range after the elements at k indices have been
+// modified. a few modified elements are moved in place one at a time: the position
+// of each is found with a binary search of the sorted elements, stepping over the
+// modified elements yet to be moved, and the element is rotated into it, so the
+// moves are only those of the d elements it passes. otherwise the modified elements
+// are moved out to a buffer and sorted, the others are moved together to close the
+// gaps they leave, and the buffer is merged back from the end, each block of the
+// others that follows a modified element being found with a galloping search and
+// moved once. a modified element is placed after the unmodified elements equivalent
+// to it, and modified elements equivalent to each other keep the order of their
+// indices. the indices may be in any order and repeated. scratch memory is allocated
+// with the allocator given. requires random access iterators
+
+namespace detail {
+
+// batches of this many modified elements or fewer are rotated into place one at a time
+size_t const resort_dirty_rotate_max = 8;
+
+// position of the element at `rank` in order among those not at the pending indices
+template<typename Holes>
+inline size_t rank_position(size_t rank, Holes const &holes, size_t pending)
+{
+    size_t position = rank;
+    for (size_t hole=pending; hole<holes.size()  &&  holes[hole] <= position; ++hole)
+        ++position;
+    return position;
+}
+
+template<typename It, typename Holes, typename Pred>
+inline void resort_by_rotation(It first, size_t size, Holes &holes, Pred &pred)
+{
+    for (size_t dirty=0; dirty<holes.size(); ++dirty)
+    {
+        // the first element not at a pending index that is greater than the modified one
+        size_t const from = holes[dirty];
+        size_t low  = 0;
+        size_t high = size - (holes.size() - dirty);
+        while (low < high)
+        {
+            size_t const middle = low + (high - low) / 2;
+            if (pred(first[from], first[detail::rank_position(middle, holes, dirty)]))
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        size_t const to = (low == size - (holes.size() - dirty))? size : detail::rank_position(low, holes, dirty);
+
+        // the pending indices, all after from, that it passes move one place towards it
+        if (from < to)
+        {
+            std::rotate(first + from, first + from + 1, first + to);
+            for (size_t hole=dirty+1; hole<holes.size()  &&  holes[hole] < to; ++hole)
+                --holes[hole];
+        }
+        else
+            std::rotate(first + to, first + from, first + from + 1);
+    }
+}
+
+template<typename It, typename Holes, typename Pred, typename Alloc>
+inline void resort_by_merge(It first, size_t size, Holes const &holes, Pred &pred, Alloc const &alloc)
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+    detail::scratch_vector<value_type, Alloc> values(alloc), buffer(alloc);
+    values.reserve(holes.size());
+    for (auto const hole : holes)
+        values.push_back(std::move(first[hole]));
+    buffer.reserve(values.size() / 2);
+    detail::merge_sort(values.data(), values.data() + values.size(), pred, buffer);
+
+    // close the gaps, so the unmodified elements are [0, size-k)
+    size_t out = holes.front();
+    for (size_t hole=0; hole<holes.size(); ++hole)
+    {
+        size_t const next = (hole + 1 < holes.size())? holes[hole + 1] : size;
+        out = std::move(first + holes[hole] + 1, first + next, first + out) - first;
+    }
+
+    // merge from the back, each modified element after the others equivalent to it
+    out = size;
+    size_t next = size - values.size();
+    for (size_t value=values.size(); value!=0; --value)
+    {
+        size_t const from = detail::gallop_upper_bound(first, first + next, values[value - 1], pred) - first;
+        std::move_backward(first + from, first + next, first + out);
+        out -= next - from;
+        next = from;
+        first[--out] = std::move(values[value - 1]);
+    }
+}
+
+}   // namespace detail
+
+template<typename It, typename Indices, typename Pred=std::less<typename std::iterator_traits<It>::value_type>, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void resort_dirty(It begin, It end, Indices const &dirty_indices, Pred pred=Pred(), Alloc const &alloc=Alloc())
+{
+    detail::scratch_vector<size_t, Alloc> holes(std::begin(dirty_indices), std::end(dirty_indices), alloc);
+    if (holes.empty())
+        return;
+    if (!std::is_sorted(holes.begin(), holes.end()))
+        detail::introsort(holes.begin(), holes.end(), std::less<size_t>(), detail::introsort_depth(holes.size()));
+    holes.erase(std::unique(holes.begin(), holes.end()), holes.end());
+
+    size_t const size = std::distance(begin, end);
+    assert(holes.back() < size);
+    auto const range = detail::kernel_range(begin, end);
+    if (holes.size() <= detail::resort_dirty_rotate_max)
+        detail::resort_by_rotation(range.first, size, holes, pred);
+    else
+        detail::resort_by_merge(range.first, size, holes, pred, alloc);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
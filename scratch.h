@@ -0,0 +1,247 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include <algorithm>    // max
+#include <cstddef>
+#include <cstdint>
+#include <memory>       // allocator_traits
+#include <new>
+#include <vector>
+
+namespace cdmh {
+
+// Scratch Memory
+//
+// algorithms that need scratch space take an optional allocator as their last
+// argument, and allocate all of their scratch memory through it, apart from the
+// state that std::thread allocates for each thread they start. an arena is a
+// monotonic allocator: each allocation takes the next bytes of its current block,
+// nothing is freed until release(), and release() makes all of the arena's memory
+// available again. an arena can start from a buffer supplied by the caller, and
+// takes further blocks from the heap only if it runs out; after a release, the
+// blocks it needed are coalesced into one, so a service that sorts the same amount
+// of data in each request makes no heap allocations after the first. an arena
+// counts the bytes allocated from it, which gives the scratch memory used by a sort.
+// arena_allocator<T> is a standard allocator that allocates from an arena, which is
+// the calling thread's own thread_arena() unless one is given. an arena is not
+// thread safe
+
+namespace detail {
+
+// default size of the blocks an arena allocates from the heap
+size_t const arena_block_size = 1 << 16;
+
+// a vector of scratch elements allocated with the allocator given to an algorithm
+template<typename T, typename Alloc>
+using scratch_vector = std::vector<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
+}   // namespace detail
+
+class arena
+{
+  public:
+    explicit arena(size_t block_size=detail::arena_block_size)
+      : block_size_(block_size)
+    {
+        reset_counts();
+    }
+
+    // an arena that allocates from the caller's buffer before using the heap
+    arena(void *buffer, size_t size, size_t block_size=detail::arena_block_size)
+      : block_size_(block_size)
+    {
+        blocks_.push_back(block(static_cast<char *>(buffer), size, false));
+        reset_counts();
+    }
+
+    ~arena()
+    {
+        for (auto const &b : blocks_)
+        {
+            if (b.owned)
+                ::operator delete(b.begin);
+        }
+    }
+
+    void *allocate(size_t bytes, size_t alignment=alignof(std::max_align_t))
+    {
+        for (;;)
+        {
+            if (current_ < blocks_.size())
+            {
+                auto const &b = blocks_[current_];
+                auto const address = reinterpret_cast<std::uintptr_t>(b.begin) + next_;
+                size_t const start = next_ + (alignment - address % alignment) % alignment;
+                if (start + bytes <= b.size)
+                {
+                    next_  = start + bytes;
+                    used_ += bytes;
+                    total_ += bytes;
+                    peak_  = std::max(peak_, used_);
+                    return b.begin + start;
+                }
+                ++current_;
+                next_ = 0;
+            }
+            else
+            {
+                size_t const size = std::max(block_size_, bytes + alignment);
+                blocks_.push_back(block(static_cast<char *>(::operator new(size)), size, true));
+            }
+        }
+    }
+
+    // make all the memory of the arena available again, coalescing the blocks that
+    // were taken from the heap into one large enough for them all
+    void release()
+    {
+        size_t owned = 0;
+        size_t size  = 0;
+        for (auto const &b : blocks_)
+        {
+            if (b.owned)
+            {
+                ++owned;
+                size += b.size;
+            }
+        }
+
+        if (owned > 1)
+        {
+            auto const first = blocks_.begin() + (blocks_.size() - owned);
+            for (auto it=first; it!=blocks_.end(); ++it)
+                ::operator delete(it->begin);
+            blocks_.erase(first, blocks_.end());
+            blocks_.push_back(block(static_cast<char *>(::operator new(size)), size, true));
+        }
+
+        current_ = 0;
+        next_    = 0;
+        used_    = 0;
+    }
+
+    // bytes allocated since the last release
+    size_t used() const
+    {
+        return used_;
+    }
+
+    // most bytes in use at once since the arena was created or reset_counts() called
+    size_t peak() const
+    {
+        return peak_;
+    }
+
+    // bytes allocated since the arena was created or reset_counts() called
+    size_t total() const
+    {
+        return total_;
+    }
+
+    void reset_counts()
+    {
+        peak_  = used_;
+        total_ = 0;
+    }
+
+  private:
+    arena(arena const &);
+    arena &operator=(arena const &);
+
+    struct block
+    {
+        block(char *begin, size_t size, bool owned) : begin(begin), size(size), owned(owned)
+        {
+        }
+
+        char   *begin;
+        size_t  size;
+        bool    owned;      // allocated from the heap by the arena, rather than the caller's
+    };
+
+    size_t             block_size_;
+    std::vector<block> blocks_;     // the caller's buffer, if any, then blocks from the heap
+    size_t             current_ = 0;
+    size_t             next_    = 0;
+    size_t             used_    = 0;
+    size_t             peak_    = 0;
+    size_t             total_   = 0;
+};
+
+// the calling thread's arena
+inline arena &thread_arena()
+{
+    static thread_local arena instance;
+    return instance;
+}
+
+template<typename T>
+class arena_allocator
+{
+  public:
+    using value_type = T;
+
+    arena_allocator() : arena_(&thread_arena())
+    {
+    }
+
+    explicit arena_allocator(cdmh::arena &a) : arena_(&a)
+    {
+    }
+
+    template<typename U>
+    arena_allocator(arena_allocator<U> const &other) : arena_(&other.arena())
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        return static_cast<T *>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_t)
+    {
+    }
+
+    cdmh::arena &arena() const
+    {
+        return *arena_;
+    }
+
+  private:
+    cdmh::arena *arena_;
+};
+
+template<typename T, typename U>
+inline bool operator==(arena_allocator<T> const &first, arena_allocator<U> const &second)
+{
+    return &first.arena() == &second.arena();
+}
+
+template<typename T, typename U>
+inline bool operator!=(arena_allocator<T> const &first, arena_allocator<U> const &second)
+{
+    return !(first == second);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
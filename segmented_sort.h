@@ -0,0 +1,137 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "insertion_sort.h"
+#include "introsort.h"
+#include "parallel_sort.h"
+#include "scratch.h"
+#include <atomic>
+#include <thread>
+
+namespace cdmh {
+
+// Segmented Sort
+//     Worst case performance       O(n log n)
+//     Average case performance     O((n/p) log s) for segments of size s
+//     Worst case space complexity  O(k) auxiliary for k segments, O(n) for large segments
+//
+// sorts each segment of a range independently, the segments being given as k+1
+// offsets into the range, segment i being [values+offsets[i], values+offsets[i+1]).
+// runs of consecutive small segments are packed into work units of similar size,
+// which the threads take from a shared counter as they become free, so a few large
+// groups do not leave threads idle. a segment too large to share a thread with other
+// work is sorted by all the threads together with parallel_sort once the work units
+// are done. small segments are sorted with insertion sort and others with introsort.
+// segmented_sort_by takes a function that returns the predicate for each segment.
+// the scratch memory of the work units and of the parallel sorts is taken from the
+// allocator given.
+// requires random access iterators
+
+namespace detail {
+
+// target number of elements in a work unit of small segments
+size_t const segmented_sort_unit = 1 << 14;
+
+// segments of this size or smaller are sorted with an insertion sort
+size_t const segmented_sort_insertion_max = 16;
+
+template<typename It, typename Pred>
+inline void sort_segment(It begin, It end, Pred pred)
+{
+    if (size_t(std::distance(begin, end)) <= segmented_sort_insertion_max)
+        cdmh::insertion_sort(begin, end, pred);
+    else
+        cdmh::introsort(begin, end, pred);
+}
+
+}   // namespace detail
+
+template<typename It, typename OffsetIt, typename PredFor, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void segmented_sort_by(It values, OffsetIt offsets_begin, OffsetIt offsets_end, PredFor pred_for, unsigned threads=std::thread::hardware_concurrency(), Alloc const &alloc=Alloc())
+{
+    auto const count = std::distance(offsets_begin, offsets_end);
+    if (count < 2)
+        return;
+    size_t const segments = count - 1;
+    threads = std::max(threads, 1u);
+
+    // a segment larger than a thread's share of the work is sorted by all the threads
+    auto const segment_size = [offsets_begin](size_t segment) {
+        return size_t(offsets_begin[segment + 1] - offsets_begin[segment]);
+    };
+    size_t const total = offsets_begin[segments] - offsets_begin[0];
+    size_t const large = std::max(total / threads, 2 * detail::parallel_sort_min_part);
+
+    // work units are runs of consecutive segments [units[i], units[i+1]) of
+    // similar total size, skipping large segments
+    detail::scratch_vector<size_t, Alloc> units(alloc);
+    detail::scratch_vector<size_t, Alloc> large_segments(alloc);
+    size_t unit_size = detail::segmented_sort_unit;
+    for (size_t segment=0; segment<segments; ++segment)
+    {
+        auto const size = segment_size(segment);
+        if (threads > 1  &&  size >= large)
+        {
+            large_segments.push_back(segment);
+            continue;
+        }
+        if (unit_size >= detail::segmented_sort_unit)
+        {
+            units.push_back(segment);
+            unit_size = 0;
+        }
+        unit_size += size;
+    }
+    units.push_back(segments);
+
+    std::atomic<size_t> next_unit(0);
+    auto const sort_units = [&]() {
+        for (size_t unit; (unit = next_unit++) + 1 < units.size(); )
+        {
+            for (size_t segment=units[unit]; segment<units[unit + 1]; ++segment)
+            {
+                if (threads == 1  ||  segment_size(segment) < large)
+                    detail::sort_segment(values + offsets_begin[segment], values + offsets_begin[segment + 1], pred_for(segment));
+            }
+        }
+    };
+
+    detail::scratch_vector<std::thread, Alloc> workers(alloc);
+    for (size_t thread=1; thread<threads; ++thread)
+        workers.emplace_back(sort_units);
+    sort_units();
+    for (auto &worker : workers)
+        worker.join();
+
+    for (auto const segment : large_segments)
+        cdmh::parallel_sort(values + offsets_begin[segment], values + offsets_begin[segment + 1], pred_for(segment), threads, alloc);
+}
+
+template<typename It, typename OffsetIt, typename Pred=std::less<typename std::iterator_traits<It>::value_type>, typename Alloc=std::allocator<typename std::iterator_traits<It>::value_type>>
+inline void segmented_sort(It values, OffsetIt offsets_begin, OffsetIt offsets_end, Pred pred=Pred(), unsigned threads=std::thread::hardware_concurrency(), Alloc const &alloc=Alloc())
+{
+    segmented_sort_by(values, offsets_begin, offsets_end, [&pred](size_t) { return pred; }, threads, alloc);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
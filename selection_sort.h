@@ -1,6 +1,8 @@
 ﻿// Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+#pragma once
+
 #include "sort.h"
 
 namespace cdmh {
@@ -12,13 +14,24 @@ namespace cdmh {
 //      Worst case space complexity О(n) total, O(1) auxiliary
 // http://en.wikipedia.org/wiki/Selection_sort
 
-template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
-inline void selection_sort(It begin, It end, Pred pred=Pred())
+namespace detail {
+
+template<typename It, typename Pred>
+inline void selection_sort(It begin, It end, Pred pred)
 {
     for (auto it=begin; it!= end; ++it)
         std::swap(*std::min_element(it, end, pred), *it);
 }
 
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline void selection_sort(It begin, It end, Pred pred=Pred())
+{
+    auto const range = detail::kernel_range(begin, end);
+    detail::selection_sort(range.first, range.second, pred);
+}
+
 }   // namespace cdmh
 
 // Permission is hereby granted, free of charge, to any person obtaining a copy
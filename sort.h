@@ -3,18 +3,109 @@
 
 #pragma once
 
+#include <deque>
 #include <functional>
+#include <iterator>
+#include <memory>       // addressof
+#include <type_traits>
+#include <utility>      // pair
+#include <vector>
+#if __cplusplus >= 202002L
+#include <version>
+#endif
+
+// the algorithms that can sort at compile time are declared CDMH_CONSTEXPR, which is
+// constexpr where the standard algorithms are, from C++20, and inline otherwise. in
+// the few places compile time evaluation has to take another path,
+// CDMH_CONSTANT_EVALUATED() tells which is being taken
+#if defined(__cpp_lib_constexpr_algorithms)  &&  defined(__cpp_lib_is_constant_evaluated)
+#define CDMH_HAS_CONSTEXPR_SORT 1
+#define CDMH_CONSTEXPR constexpr
+#define CDMH_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define CDMH_HAS_CONSTEXPR_SORT 0
+#define CDMH_CONSTEXPR inline
+#define CDMH_CONSTANT_EVALUATED() false
+#endif
 
 namespace cdmh {
+
+// a contiguous iterator refers to elements that are adjacent in memory, so algorithms
+// can run on pointers to the elements instead. pointers and the iterators of
+// std::vector (other than vector<bool>) are detected; specialise this for others
+template<typename It, typename T=typename std::iterator_traits<It>::value_type>
+struct is_contiguous_iterator
+  : std::integral_constant<bool,
+        std::is_pointer<It>::value
+    ||  (!std::is_same<T, bool>::value
+        &&  (std::is_same<It, typename std::vector<T>::iterator>::value
+        ||   std::is_same<It, typename std::vector<T>::const_iterator>::value))>
+{
+};
+
+// the iterators of a std::deque refer to elements held in contiguous blocks, which
+// the sorts find and sort through pointers before merging them; specialise this for
+// other containers with the same layout
+template<typename It, typename T=typename std::iterator_traits<It>::value_type>
+struct is_deque_iterator
+  : std::integral_constant<bool,
+        std::is_same<It, typename std::deque<T>::iterator>::value
+    ||  std::is_same<It, typename std::deque<T>::const_iterator>::value>
+{
+};
+
 namespace detail {
 
 template <typename It, typename Distance>
-inline It advance(It it, Distance n)
+CDMH_CONSTEXPR It advance(It it, Distance n)
 {
     std::advance(it, n);
     return it;
 }
 
+// the iterator type an algorithm runs on for a range of It, which is a pointer to
+// the elements of a contiguous range, so generic code makes no iterator calls
+template<typename It, bool Contiguous=is_contiguous_iterator<It>::value>
+struct kernel
+{
+    using iterator = It;
+
+    CDMH_CONSTEXPR static std::pair<iterator, iterator> range(It begin, It end)
+    {
+        return std::make_pair(begin, end);
+    }
+
+    // the iterator of the range for an iterator of the kernel range starting at first
+    CDMH_CONSTEXPR static It from(It, iterator, iterator it)
+    {
+        return it;
+    }
+};
+
+template<typename It>
+struct kernel<It, true>
+{
+    using iterator = typename std::iterator_traits<It>::pointer;
+
+    // the end of a range cannot be dereferenced, so both pointers are found from begin
+    CDMH_CONSTEXPR static std::pair<iterator, iterator> range(It begin, It end)
+    {
+        iterator const first = (begin == end)? nullptr : std::addressof(*begin);
+        return std::make_pair(first, first + (end - begin));
+    }
+
+    CDMH_CONSTEXPR static It from(It begin, iterator first, iterator it)
+    {
+        return begin + (it - first);
+    }
+};
+
+template<typename It>
+CDMH_CONSTEXPR std::pair<typename kernel<It>::iterator, typename kernel<It>::iterator> kernel_range(It begin, It end)
+{
+    return kernel<It>::range(begin, end);
+}
+
 }   // namespace detail
 }   // namespace cdmh
 
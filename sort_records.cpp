@@ -0,0 +1,125 @@
+// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+// sort a file of fixed-width binary records in place
+//
+//   sort_records <file> <record size> <key offset> <key length> [algorithm]
+//
+// algorithm is one of introsort (default), quicksort, heap_sort or merge_sort
+
+#include "heap_sort.h"
+#include "introsort.h"
+#include "merge_sort.h"
+#include "quicksort.h"
+#include "record_sort.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+// function objects to pass a sort algorithm without naming its template arguments
+struct heap_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::heap_sort(begin, end, pred); }
+};
+
+struct introsort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::introsort(begin, end, pred); }
+};
+
+struct merge_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::merge_sort(begin, end, pred); }
+};
+
+struct quicksort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::quicksort(begin, end, pred); }
+};
+
+// common record sizes are sorted in place as record<Size>, others through an index
+template<typename Sort>
+void sort_file(std::string const &path, size_t record_size, size_t key_offset, size_t key_length, Sort sort)
+{
+    switch (record_size)
+    {
+        case 4:   cdmh::sort_mapped_file<4>(path, key_offset, key_length, sort);   break;
+        case 8:   cdmh::sort_mapped_file<8>(path, key_offset, key_length, sort);   break;
+        case 16:  cdmh::sort_mapped_file<16>(path, key_offset, key_length, sort);  break;
+        case 32:  cdmh::sort_mapped_file<32>(path, key_offset, key_length, sort);  break;
+        case 64:  cdmh::sort_mapped_file<64>(path, key_offset, key_length, sort);  break;
+        case 100: cdmh::sort_mapped_file<100>(path, key_offset, key_length, sort); break;
+        case 128: cdmh::sort_mapped_file<128>(path, key_offset, key_length, sort); break;
+        default:  cdmh::sort_mapped_file(path, record_size, key_offset, key_length, sort); break;
+    }
+}
+
+int usage()
+{
+    std::cerr << "usage: sort_records <file> <record size> <key offset> <key length> [introsort|quicksort|heap_sort|merge_sort]\n";
+    return EXIT_FAILURE;
+}
+
+}   // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 5  ||  argc > 6)
+        return usage();
+
+    std::string const path(argv[1]);
+    size_t const record_size = std::strtoul(argv[2], nullptr, 10);
+    size_t const key_offset  = std::strtoul(argv[3], nullptr, 10);
+    size_t const key_length  = std::strtoul(argv[4], nullptr, 10);
+    std::string const algorithm(argc == 6? argv[5] : "introsort");
+
+    try
+    {
+        auto const start = std::chrono::steady_clock::now();
+        if (algorithm == "introsort")
+            sort_file(path, record_size, key_offset, key_length, introsort_engine());
+        else if (algorithm == "quicksort")
+            sort_file(path, record_size, key_offset, key_length, quicksort_engine());
+        else if (algorithm == "heap_sort")
+            sort_file(path, record_size, key_offset, key_length, heap_sort_engine());
+        else if (algorithm == "merge_sort")
+            sort_file(path, record_size, key_offset, key_length, merge_sort_engine());
+        else
+            return usage();
+
+        std::clog << algorithm << " sorted " << path << " in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+                  << "ms\n";
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << "sort_records: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,241 @@
+// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+// replay the sort calls recorded by cdmh::sort_sampler against each algorithm
+//
+//   sort_replay <samples file>
+//
+// for each sample, an input of the same size, a value type of the same kind and size,
+// and the same number of ascending runs is synthesised and sorted by every algorithm
+// that supports the sample's iterator category; random access samples are replayed
+// in a std::vector, and others in a std::list. the fingerprint of the synthesised
+// input is shown beside the recorded one, and the total time of each algorithm over
+// all the samples is reported at the end. values of other types are replayed as
+// 64 bit integers
+
+#include "deque_sort.h"
+#include "heap_sort.h"
+#include "insertion_sort.h"
+#include "introsort.h"
+#include "merge_sort.h"
+#include "parallel_sort.h"
+#include "quicksort.h"
+#include "sort_sampler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <list>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// larger inputs are not replayed with the quadratic insertion sort
+size_t const insertion_sort_max = 20000;
+
+std::mt19937_64 rng;
+
+// function objects to pass a sort algorithm without naming its template arguments
+struct std_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { std::sort(begin, end, pred); }
+};
+
+struct std_stable_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { std::stable_sort(begin, end, pred); }
+};
+
+struct deque_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::deque_sort(begin, end, pred); }
+};
+
+struct heap_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::heap_sort(begin, end, pred); }
+};
+
+struct insertion_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::insertion_sort(begin, end, pred); }
+};
+
+struct introsort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::introsort(begin, end, pred); }
+};
+
+struct merge_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::merge_sort(begin, end, pred); }
+};
+
+struct parallel_sort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::parallel_sort(begin, end, pred); }
+};
+
+struct quicksort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::quicksort(begin, end, pred); }
+};
+
+template<typename T>
+T random_value(std::true_type)
+{
+    return T(rng());
+}
+
+template<typename T>
+T random_value(std::false_type)
+{
+    std::string value(16, ' ');
+    for (auto &c : value)
+        c = char('a' + rng() % 26);
+    return value;
+}
+
+// n values with about `runs` ascending runs: m random values have about m / 2 runs,
+// so a sorted run of values is followed by 2 * (runs - 1) random values. more runs
+// than a random order has are given by reversing values with n - runs + 1 runs
+template<typename T>
+std::vector<T> synthesise(size_t size, size_t runs)
+{
+    std::vector<T> values;
+    values.reserve(size);
+    for (size_t loop=0; loop<size; ++loop)
+        values.push_back(random_value<T>(std::is_arithmetic<T>()));
+
+    bool const reversed = runs > size / 2;
+    size_t const target = reversed? size - std::min(size, runs) + 1 : std::max<size_t>(runs, 1);
+    size_t const random = std::min(size, 2 * (target - 1));
+    std::sort(values.begin(), values.end() - random);
+    if (reversed)
+        std::reverse(values.begin(), values.end());
+    return values;
+}
+
+std::map<std::string, double> totals;   // milliseconds spent by each algorithm
+
+template<typename C, typename Sort>
+void replay(char const *name, std::vector<typename C::value_type> const &values, Sort sort)
+{
+    C container(values.begin(), values.end());
+    auto const start = std::chrono::steady_clock::now();
+    sort(container.begin(), container.end(), std::less<typename C::value_type>());
+    double const ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    totals[name] += ms;
+    std::cout << ' ' << name << ' ' << ms << "ms";
+}
+
+template<typename T>
+void replay(cdmh::sort_sample const &sample)
+{
+    auto values = synthesise<T>(sample.size, sample.runs);
+    cdmh::sort_sample synthesised = cdmh::sort_sample();
+    std::less<T> pred;
+    cdmh::detail::fingerprint(values.begin(), values.end(), pred, synthesised);
+
+    std::cout << cdmh::sort_sample::name(cdmh::sort_sample::algorithm_id(sample.algorithm))
+              << " n=" << sample.size
+              << " runs=" << sample.runs << '/' << synthesised.runs
+              << " inversions=" << sample.inversions << '/' << synthesised.inversions << " of " << sample.pairs
+              << " recorded " << sample.nanoseconds / 1e6 << "ms:";
+
+    if (sample.category >= cdmh::sort_sample::random_access)
+    {
+        replay<std::vector<T>>("std::sort", values, std_sort_engine());
+        replay<std::vector<T>>("std::stable_sort", values, std_stable_sort_engine());
+        replay<std::vector<T>>("introsort", values, introsort_engine());
+        replay<std::vector<T>>("quicksort", values, quicksort_engine());
+        replay<std::vector<T>>("heap_sort", values, heap_sort_engine());
+        replay<std::vector<T>>("merge_sort", values, merge_sort_engine());
+        replay<std::vector<T>>("parallel_sort", values, parallel_sort_engine());
+        replay<std::deque<T>>("deque_sort", values, deque_sort_engine());
+        if (sample.size <= insertion_sort_max)
+            replay<std::vector<T>>("insertion_sort", values, insertion_sort_engine());
+    }
+    else
+    {
+        replay<std::list<T>>("introsort", values, introsort_engine());
+        replay<std::list<T>>("quicksort", values, quicksort_engine());
+        replay<std::list<T>>("merge_sort", values, merge_sort_engine());
+        if (sample.size <= insertion_sort_max)
+            replay<std::list<T>>("insertion_sort", values, insertion_sort_engine());
+    }
+    std::cout << '\n';
+}
+
+void replay(cdmh::sort_sample const &sample)
+{
+    bool const wide = sample.value_size > 4;
+    switch (sample.value)
+    {
+        case cdmh::sort_sample::signed_integer:     wide? replay<std::int64_t>(sample)  : replay<std::int32_t>(sample);  break;
+        case cdmh::sort_sample::unsigned_integer:   wide? replay<std::uint64_t>(sample) : replay<std::uint32_t>(sample); break;
+        case cdmh::sort_sample::floating_point:     wide? replay<double>(sample)        : replay<float>(sample);         break;
+        case cdmh::sort_sample::string:             replay<std::string>(sample);  break;
+        default:                                    replay<std::int64_t>(sample); break;
+    }
+}
+
+}   // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: sort_replay <samples file>\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<cdmh::sort_sample> samples;
+    if (!cdmh::sort_sampler::read(argv[1], samples))
+    {
+        std::cerr << "sort_replay: " << argv[1] << " is not a file of sort samples\n";
+        return EXIT_FAILURE;
+    }
+
+    for (auto const &sample : samples)
+        replay(sample);
+
+    std::cout << samples.size() << " samples replayed\n";
+    for (auto const &total : totals)
+        std::cout << total.first << ' ' << total.second << "ms\n";
+    return EXIT_SUCCESS;
+}
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,423 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include <algorithm>    // min, max
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>      // memcmp
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cdmh {
+
+// Sort Sampler
+//
+// records a sample of the calls to the sort algorithms in a binary file, so the sizes,
+// types and presortedness of a real workload can be replayed offline with the
+// sort_replay tool. the hooks in the algorithms are compiled in only if
+// CDMH_SORT_SAMPLING is defined, and do nothing until sort_sampler::start() is called;
+// about one call in `rate` is then sampled. a sampled call first takes a fingerprint of
+// its input in one pass, counting the ascending runs and the out of order pairs among
+// elements sampled at even spacing, and then times the sort. each thread keeps its
+// samples in a ring buffer of its own, without locks, and appends them to the file
+// when the ring is full, on flush(), or when the thread ends; a ring that cannot be
+// written because sampling has stopped keeps its latest samples. the calls an
+// algorithm with a hook makes to others, on its own thread or on the threads it
+// starts, are part of its sample and are not sampled themselves
+
+// one sampled call, as written to the file in the byte order of the host
+struct sort_sample
+{
+    enum algorithm_id : std::uint8_t { insertion_sort, heap_sort, quicksort, introsort, merge_sort, parallel_sort, deque_sort, algorithm_count };
+    enum value_kind   : std::uint8_t { other, signed_integer, unsigned_integer, floating_point, string };
+    enum category_id  : std::uint8_t { forward, bidirectional, random_access, contiguous };
+
+    std::uint64_t size;
+    std::uint64_t nanoseconds;
+    std::uint32_t runs;         // ascending runs, saturating
+    std::uint16_t inversions;   // out of order pairs among the fingerprint's elements
+    std::uint16_t pairs;        // pairs of elements compared for the fingerprint
+    std::uint16_t value_size;   // sizeof the value type
+    std::uint8_t  value;        // value_kind
+    std::uint8_t  category;     // category_id
+    std::uint8_t  algorithm;    // algorithm_id
+    std::uint8_t  reserved[3];
+
+    static char const *name(algorithm_id algorithm)
+    {
+        static char const *const names[] = {
+            "insertion_sort", "heap_sort", "quicksort", "introsort", "merge_sort", "parallel_sort", "deque_sort"
+        };
+        return (algorithm < algorithm_count)? names[algorithm] : "unknown";
+    }
+};
+
+static_assert(sizeof(sort_sample) == 32, "sort samples are written to file as 32 bytes");
+
+namespace detail {
+
+// the identifying bytes at the start of a sample file
+char const sort_sample_magic[8] = { 'c', 'd', 'm', 'h', 's', 'm', 'p', '1' };
+
+// samples held by each thread before they are written
+size_t const sort_sample_ring = 256;
+
+// elements taken at even spacing for the count of out of order pairs
+size_t const sort_sample_fingerprint = 32;
+
+struct sort_sampler_state
+{
+    sort_sampler_state() : rate(0), file(nullptr)
+    {
+    }
+
+    std::atomic<unsigned> rate;     // sample about one call in rate, or none if 0
+    std::mutex            mutex;    // serialises writes to the file
+    std::FILE            *file;
+};
+
+inline sort_sampler_state &sampler_state()
+{
+    static sort_sampler_state state;
+    return state;
+}
+
+class sample_ring
+{
+  public:
+    sample_ring() : next_(0), count_(0), rng_(0x9e3779b9u), depth_(0)
+    {
+    }
+
+    ~sample_ring()
+    {
+        flush();
+    }
+
+    // true for about one call in rate
+    bool sample(unsigned rate)
+    {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        return rng_ % rate == 0;
+    }
+
+    void push(sort_sample const &sample)
+    {
+        ring_[next_] = sample;
+        next_  = (next_ + 1) % sort_sample_ring;
+        count_ = std::min(count_ + 1, sort_sample_ring);
+        if (count_ == sort_sample_ring)
+            flush();
+    }
+
+    // write the samples in the order they were taken, keeping them if there is no file
+    void flush()
+    {
+        // the ring belongs to this thread, so only the file needs the lock
+        if (count_ == 0)
+            return;
+
+        auto &state = detail::sampler_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.file == nullptr)
+            return;
+
+        size_t const first = (next_ + sort_sample_ring - count_) % sort_sample_ring;
+        size_t const tail  = std::min(count_, sort_sample_ring - first);
+        std::fwrite(ring_ + first, sizeof(sort_sample), tail, state.file);
+        std::fwrite(ring_, sizeof(sort_sample), count_ - tail, state.file);
+        count_ = 0;
+    }
+
+    // number of hooked calls in progress on this thread, so nested calls are not sampled
+    unsigned &depth()
+    {
+        return depth_;
+    }
+
+  private:
+    sort_sample   ring_[sort_sample_ring];
+    size_t        next_;
+    size_t        count_;
+    std::uint32_t rng_;
+    unsigned      depth_;
+};
+
+inline sample_ring &thread_samples()
+{
+    static thread_local sample_ring ring;
+    return ring;
+}
+
+template<typename T>
+struct sample_value_kind
+  : std::integral_constant<sort_sample::value_kind,
+        std::is_same<T, std::string>::value?   sort_sample::string
+      : std::is_floating_point<T>::value?      sort_sample::floating_point
+      : std::is_signed<T>::value?              sort_sample::signed_integer
+      : std::is_integral<T>::value?            sort_sample::unsigned_integer
+      : sort_sample::other>
+{
+};
+
+template<typename It>
+inline sort_sample::category_id sample_category(std::forward_iterator_tag)
+{
+    return sort_sample::forward;
+}
+
+template<typename It>
+inline sort_sample::category_id sample_category(std::bidirectional_iterator_tag)
+{
+    return sort_sample::bidirectional;
+}
+
+template<typename It>
+inline sort_sample::category_id sample_category(std::random_access_iterator_tag)
+{
+    return is_contiguous_iterator<It>::value? sort_sample::contiguous : sort_sample::random_access;
+}
+
+// the size, runs and sampled inversions of [begin, end), found in one pass
+template<typename It, typename Pred>
+inline void fingerprint(It begin, It end, Pred &pred, sort_sample &sample)
+{
+    size_t const size = std::distance(begin, end);
+    sample.size = size;
+    sample.runs = (size == 0)? 0 : 1;
+
+    size_t const count = std::min(size, sort_sample_fingerprint);
+    std::vector<It> elements;
+    elements.reserve(count);
+
+    size_t index = 0;
+    for (It it=begin, previous=begin; it!=end; previous=it++, ++index)
+    {
+        if (it != begin  &&  pred(*it, *previous)  &&  sample.runs != UINT32_MAX)
+            ++sample.runs;
+        if (elements.size() < count  &&  index == elements.size() * size / count)
+            elements.push_back(it);
+    }
+
+    sample.inversions = 0;
+    sample.pairs      = std::uint16_t(count * (count - (count != 0)) / 2);
+    for (size_t first=0; first<elements.size(); ++first)
+    {
+        for (size_t second=first+1; second<elements.size(); ++second)
+        {
+            if (pred(*elements[second], *elements[first]))
+                ++sample.inversions;
+        }
+    }
+}
+
+#if defined(CDMH_SORT_SAMPLING)
+// a hook in a sort algorithm that samples the call it is constructed in, if chosen
+template<typename It, typename Pred>
+class sample_scope
+{
+  public:
+    CDMH_CONSTEXPR sample_scope(sort_sample::algorithm_id algorithm, It begin, It end, Pred &pred)
+      : ring_(nullptr),
+        sampled_(false)
+    {
+        // nothing is sampled at compile time
+        if (!CDMH_CONSTANT_EVALUATED())
+            start(algorithm, begin, end, pred);
+    }
+
+    CDMH_CONSTEXPR ~sample_scope()
+    {
+        if (ring_ != nullptr)
+            finish();
+    }
+
+  private:
+    sample_scope(sample_scope const &);
+    sample_scope &operator=(sample_scope const &);
+
+    void start(sort_sample::algorithm_id algorithm, It begin, It end, Pred &pred);
+    void finish();
+
+    sample_ring                          *ring_;     // the thread's ring if the call is outermost
+    bool                                  sampled_;
+    sort_sample                           sample_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+template<typename It, typename Pred>
+inline void sample_scope<It, Pred>::start(sort_sample::algorithm_id algorithm, It begin, It end, Pred &pred)
+{
+    unsigned const rate = detail::sampler_state().rate.load(std::memory_order_relaxed);
+    if (rate == 0)
+        return;
+
+    auto &ring = detail::thread_samples();
+    if (ring.depth() != 0)
+        return;
+
+    ring_ = &ring;
+    ++ring.depth();
+    sampled_ = ring.sample(rate);
+    if (!sampled_)
+        return;
+
+    using value_type = typename std::iterator_traits<It>::value_type;
+    sample_ = sort_sample();
+    sample_.algorithm  = algorithm;
+    sample_.value      = sample_value_kind<value_type>::value;
+    sample_.value_size = std::uint16_t(std::min<size_t>(sizeof(value_type), UINT16_MAX));
+    sample_.category   = detail::sample_category<It>(typename std::iterator_traits<It>::iterator_category());
+    detail::fingerprint(begin, end, pred, sample_);
+    start_ = std::chrono::steady_clock::now();
+}
+
+template<typename It, typename Pred>
+inline void sample_scope<It, Pred>::finish()
+{
+    --ring_->depth();
+    if (sampled_)
+    {
+        sample_.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        ring_->push(sample_);
+    }
+}
+
+// marks a thread started by a hooked algorithm, so the calls it makes are not sampled.
+// while sampling is stopped the thread's ring is not created
+class nested_sample_scope
+{
+  public:
+    nested_sample_scope() : ring_(nullptr)
+    {
+        if (detail::sampler_state().rate.load(std::memory_order_relaxed) == 0)
+            return;
+
+        ring_ = &detail::thread_samples();
+        ++ring_->depth();
+    }
+
+    ~nested_sample_scope()
+    {
+        if (ring_ != nullptr)
+            --ring_->depth();
+    }
+
+  private:
+    nested_sample_scope(nested_sample_scope const &);
+    nested_sample_scope &operator=(nested_sample_scope const &);
+
+    sample_ring *ring_;     // the thread's ring if sampling was running
+};
+#else
+template<typename It, typename Pred>
+class sample_scope
+{
+  public:
+    CDMH_CONSTEXPR sample_scope(sort_sample::algorithm_id, It, It, Pred &)
+    {
+    }
+};
+
+class nested_sample_scope
+{
+  public:
+    nested_sample_scope()
+    {
+    }
+};
+#endif
+
+}   // namespace detail
+
+class sort_sampler
+{
+  public:
+    // sample about one call in `rate` to a new file at `path`; false if it can't be created
+    static bool start(char const *path, unsigned rate)
+    {
+        auto &state = detail::sampler_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.file != nullptr)
+            std::fclose(state.file);
+
+        state.file = std::fopen(path, "wb");
+        if (state.file == nullptr
+        ||  std::fwrite(detail::sort_sample_magic, sizeof(detail::sort_sample_magic), 1, state.file) != 1)
+        {
+            state.rate = 0;
+            return false;
+        }
+        state.rate = std::max(rate, 1u);
+        return true;
+    }
+
+    // write the calling thread's samples to the file
+    static void flush()
+    {
+        detail::thread_samples().flush();
+    }
+
+    // stop sampling, and write the calling thread's samples and close the file. the
+    // samples other threads have not yet written are kept until sampling restarts
+    static void stop()
+    {
+        auto &state = detail::sampler_state();
+        state.rate = 0;
+        flush();
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.file != nullptr)
+        {
+            std::fclose(state.file);
+            state.file = nullptr;
+        }
+    }
+
+    // read the samples from a file written by the sampler
+    static bool read(char const *path, std::vector<sort_sample> &samples)
+    {
+        std::FILE *file = std::fopen(path, "rb");
+        if (file == nullptr)
+            return false;
+
+        char magic[sizeof(detail::sort_sample_magic)];
+        bool const valid = std::fread(magic, sizeof(magic), 1, file) == 1
+                       &&  std::memcmp(magic, detail::sort_sample_magic, sizeof(magic)) == 0;
+        sort_sample sample;
+        while (valid  &&  std::fread(&sample, sizeof(sample), 1, file) == 1)
+            samples.push_back(sample);
+        std::fclose(file);
+        return valid;
+    }
+};
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,276 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "insertion_sort.h"
+#include "nth_element.h"        // introselect_depth
+#include <algorithm>            // push_heap, pop_heap
+#include <chrono>
+#include <vector>
+
+namespace cdmh {
+
+// Sort Task (Cooperative Sort)
+//     Worst case performance       O(n log n)
+//     Average case performance     O(n log n)
+//     Worst case space complexity  O(log n) auxiliary
+//
+// an introsort of a random access range that runs in slices, for a caller such as an
+// event loop that cannot block for the whole sort. each call to resume() does a
+// bounded amount of work, counted in elements visited, or resume_for() runs until a
+// time slice has passed, and returns whether the sort has finished. the recursion of
+// introsort is kept as an explicit stack of unsorted segments, as in the lazy sorted
+// view, and the three-way partition of a segment and the heap sort that replaces it
+// beyond the depth limit are both done one element at a time, so a slice can end part
+// way through either and no single step visits more than a small segment's elements.
+// cancel() stops the sort before the next slice, leaving the range a permutation of
+// its elements
+
+namespace detail {
+
+// segments of this size or smaller are sorted with an insertion sort in a single step
+size_t const sort_task_threshold = 16;
+
+// number of elements visited between checks of the clock in resume_for()
+size_t const sort_task_clock_interval = 4096;
+
+}   // namespace detail
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+class sort_task
+{
+  public:
+    sort_task(It begin, It end, Pred pred=Pred())
+      : begin_(detail::kernel_range(begin, end).first),
+        pred_(pred),
+        current_(0, 0, 0),
+        phase_(idle),
+        less_(0),
+        unknown_(0),
+        greater_(0),
+        heap_(0),
+        work_(0),
+        cancelled_(false)
+    {
+        size_t const size = std::distance(begin, end);
+        if (size > 1)
+            segments_.push_back(segment(0, size, detail::introselect_depth(size)));
+    }
+
+    // sort for about `budget` element visits; returns true once the task is done
+    bool resume(size_t budget)
+    {
+        size_t const limit = work_ + std::max<size_t>(budget, 1);
+        while (work_ < limit  &&  !done())
+        {
+            switch (phase_)
+            {
+                case idle:          next_segment();     break;
+                case partitioning:  partition(limit);   break;
+                case heap_building: build_heap(limit);  break;
+                case heap_popping:  sort_heap(limit);   break;
+            }
+        }
+        return done();
+    }
+
+    // sort until the slice of time has passed; returns true once the task is done
+    template<typename Rep, typename Period>
+    bool resume_for(std::chrono::duration<Rep, Period> const &slice)
+    {
+        auto const deadline = std::chrono::steady_clock::now() + slice;
+        while (!resume(detail::sort_task_clock_interval))
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+        }
+        return true;
+    }
+
+    // run the task to the end, as a blocking sort
+    void run()
+    {
+        while (!resume(detail::sort_task_clock_interval))
+            ;
+    }
+
+    void cancel()
+    {
+        cancelled_ = true;
+    }
+
+    bool cancelled() const
+    {
+        return cancelled_;
+    }
+
+    // true if the range is sorted or the task has been cancelled
+    bool done() const
+    {
+        return cancelled_  ||  (phase_ == idle  &&  segments_.empty());
+    }
+
+    // number of element visits so far
+    size_t work() const
+    {
+        return work_;
+    }
+
+  private:
+    using iterator = typename detail::kernel<It>::iterator;
+
+    enum phase { idle, partitioning, heap_building, heap_popping };
+
+    struct segment
+    {
+        segment(size_t begin, size_t end, size_t depth) : begin(begin), end(end), depth(depth)
+        {
+        }
+
+        size_t begin;
+        size_t end;
+        size_t depth;   // partitions left before the segment is heap sorted
+    };
+
+    // take the segment from the top of the stack, sorting it at once if it is small
+    void next_segment()
+    {
+        current_ = segments_.back();
+        segments_.pop_back();
+
+        size_t const size = current_.end - current_.begin;
+        if (size <= detail::sort_task_threshold)
+        {
+            detail::insertion_sort(begin_ + current_.begin, begin_ + current_.end, pred_);
+            work_ += size;
+        }
+        else if (current_.depth == 0)
+        {
+            phase_ = heap_building;
+            heap_  = 1;
+        }
+        else
+        {
+            // the median of three is moved to the front to start the block of elements
+            // equivalent to the pivot, which is the pivot the partition compares with
+            iterator const first  = begin_ + current_.begin;
+            iterator const middle = first + size / 2;
+            iterator const last   = begin_ + current_.end - 1;
+            iterator pivot = middle;
+            if (pred_(*first, *middle) != pred_(*first, *last))
+                pivot = first;
+            else if (pred_(*middle, *last) != pred_(*first, *last))
+                pivot = last;
+            std::iter_swap(first, pivot);
+
+            less_    = current_.begin;
+            unknown_ = current_.begin + 1;
+            greater_ = current_.end;
+            phase_   = partitioning;
+            work_   += 3;
+        }
+    }
+
+    // [begin, less_) < pivot, [less_, unknown_) == pivot, [greater_, end) > pivot
+    void partition(size_t limit)
+    {
+        for (; unknown_ != greater_  &&  work_ < limit; ++work_)
+        {
+            iterator const element = begin_ + unknown_;
+            iterator const pivot   = begin_ + less_;
+            if (pred_(*element, *pivot))
+            {
+                std::iter_swap(element, pivot);
+                ++less_;
+                ++unknown_;
+            }
+            else if (pred_(*pivot, *element))
+                std::iter_swap(element, begin_ + --greater_);
+            else
+                ++unknown_;
+        }
+        if (unknown_ != greater_)
+            return;
+
+        // the smaller side is pushed last and sorted first, so the stack stays O(log n)
+        segment const less(current_.begin, less_, current_.depth - 1);
+        segment const greater(greater_, current_.end, current_.depth - 1);
+        bool const less_first = (less.end - less.begin) < (greater.end - greater.begin);
+        push(less_first? greater : less);
+        push(less_first? less : greater);
+        phase_ = idle;
+    }
+
+    void push(segment const &s)
+    {
+        if (s.end - s.begin > 1)
+            segments_.push_back(s);
+    }
+
+    // the heap is built by pushing each element in turn, and then sorted by popping
+    // each in turn, so both halves of the heap sort can stop after any element
+    void build_heap(size_t limit)
+    {
+        iterator const first = begin_ + current_.begin;
+        size_t   const size  = current_.end - current_.begin;
+        for (; heap_ < size  &&  work_ < limit; ++work_)
+            std::push_heap(first, first + ++heap_, pred_);
+        if (heap_ == size)
+            phase_ = heap_popping;
+    }
+
+    void sort_heap(size_t limit)
+    {
+        iterator const first = begin_ + current_.begin;
+        for (; heap_ > 1  &&  work_ < limit; ++work_)
+            std::pop_heap(first, first + heap_--, pred_);
+        if (heap_ == 1)
+            phase_ = idle;
+    }
+
+    iterator             begin_;
+    Pred                 pred_;
+    std::vector<segment> segments_;     // stack of unsorted segments, next to sort on top
+    segment              current_;
+    phase                phase_;
+    size_t               less_;
+    size_t               unknown_;
+    size_t               greater_;
+    size_t               heap_;         // size of the heap in the current segment
+    size_t               work_;
+    bool                 cancelled_;
+};
+
+template<typename It, typename Pred>
+inline sort_task<It, Pred> make_sort_task(It begin, It end, Pred pred)
+{
+    return sort_task<It, Pred>(begin, end, pred);
+}
+
+template<typename It>
+inline sort_task<It> make_sort_task(It begin, It end)
+{
+    return sort_task<It>(begin, end);
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,281 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include <algorithm>    // sort
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace cdmh {
+
+// Sort Trace
+//
+// records where the time of the recursive and parallel sorts goes, as spans that can
+// be loaded into a trace viewer that reads the Chrome trace_event format, such as
+// chrome://tracing or Perfetto. the hooks in the algorithms are compiled in only if
+// CDMH_SORT_TRACING is defined, and do nothing until sort_trace::start() is called;
+// each recursive call of quicksort, introsort and merge_sort on a subrange of at least
+// `min_size` elements is then a span, with child spans for its partition, heap sort
+// or merge step, and parallel_sort records a span for the whole sort on the calling
+// thread and one for each part of its k-way merge on the thread that merges it. a span
+// records its phase, subrange size, thread and start and end times, and its depth,
+// the number of spans open on its thread when it began, which follows the recursion.
+// each thread appends the spans it ends to a buffer of its own without locking, and a
+// buffer's spans are kept when its thread ends. start() clears, and events() and
+// write() read, the buffers of all threads, so they must be called when no traced
+// sort is running
+
+// one span, timed in nanoseconds from the call to sort_trace::start()
+struct trace_event
+{
+    enum phase_id : std::uint8_t { sort, partition, leaf_sort, merge, phase_count };
+
+    char const    *name;        // the algorithm or step, a string literal
+    std::uint64_t  start;
+    std::uint64_t  end;
+    std::uint64_t  size;        // elements in the subrange
+    std::uint32_t  thread;      // numbered from 0 in the order threads first record a span
+    std::uint16_t  depth;       // spans open on the thread when this one began
+    std::uint8_t   phase;       // phase_id
+
+    static char const *phase_name(phase_id phase)
+    {
+        static char const *const names[] = { "sort", "partition", "leaf_sort", "merge" };
+        return (phase < phase_count)? names[phase] : "unknown";
+    }
+};
+
+namespace detail {
+
+// default size of the smallest subrange recorded as a span
+size_t const sort_trace_min_size = 1 << 12;
+
+inline std::int64_t trace_clock()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class trace_buffer;
+
+struct sort_trace_state
+{
+    sort_trace_state() : min_size(SIZE_MAX), origin(detail::trace_clock()), threads(0)
+    {
+    }
+
+    std::atomic<size_t>        min_size;   // smallest subrange recorded, or SIZE_MAX if stopped
+    std::atomic<std::int64_t>  origin;     // trace_clock() when tracing started
+    std::atomic<std::uint32_t> threads;    // number of thread ids given out
+    std::mutex                 mutex;      // guards the lists of buffers and retired events
+    std::vector<trace_buffer *> buffers;   // the buffers of running threads
+    std::vector<trace_event>   retired;    // the events of threads that have ended
+};
+
+inline sort_trace_state &trace_state()
+{
+    static sort_trace_state state;
+    return state;
+}
+
+class trace_buffer
+{
+  public:
+    trace_buffer() : depth_(0)
+    {
+        auto &state = detail::trace_state();
+        thread_ = state.threads++;
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.buffers.push_back(this);
+    }
+
+    ~trace_buffer()
+    {
+        auto &state = detail::trace_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.retired.insert(state.retired.end(), events_.begin(), events_.end());
+        state.buffers.erase(std::find(state.buffers.begin(), state.buffers.end(), this));
+    }
+
+    std::vector<trace_event> &events()
+    {
+        return events_;
+    }
+
+    std::uint32_t thread() const
+    {
+        return thread_;
+    }
+
+    // number of spans open on this thread
+    std::uint16_t &depth()
+    {
+        return depth_;
+    }
+
+  private:
+    trace_buffer(trace_buffer const &);
+    trace_buffer &operator=(trace_buffer const &);
+
+    std::vector<trace_event> events_;
+    std::uint32_t            thread_;
+    std::uint16_t            depth_;
+};
+
+inline trace_buffer &thread_trace()
+{
+    static thread_local trace_buffer buffer;
+    return buffer;
+}
+
+#if defined(CDMH_SORT_TRACING)
+// a hook in a sort algorithm that records the scope it is constructed in as a span
+class trace_span
+{
+  public:
+    CDMH_CONSTEXPR trace_span(trace_event::phase_id phase, char const *name, size_t size)
+      : buffer_(nullptr)
+    {
+        // nothing is traced at compile time
+        if (!CDMH_CONSTANT_EVALUATED())
+            begin(phase, name, size);
+    }
+
+    CDMH_CONSTEXPR ~trace_span()
+    {
+        if (buffer_ != nullptr)
+            end();
+    }
+
+  private:
+    trace_span(trace_span const &);
+    trace_span &operator=(trace_span const &);
+
+    void begin(trace_event::phase_id phase, char const *name, size_t size)
+    {
+        auto &state = detail::trace_state();
+        if (size < state.min_size.load(std::memory_order_relaxed))
+            return;
+
+        buffer_ = &detail::thread_trace();
+        event_.name   = name;
+        event_.size   = size;
+        event_.thread = buffer_->thread();
+        event_.depth  = buffer_->depth()++;
+        event_.phase  = phase;
+        event_.start  = std::uint64_t(detail::trace_clock() - state.origin.load(std::memory_order_relaxed));
+    }
+
+    void end()
+    {
+        event_.end = std::uint64_t(detail::trace_clock() - detail::trace_state().origin.load(std::memory_order_relaxed));
+        --buffer_->depth();
+        buffer_->events().push_back(event_);
+    }
+
+    trace_buffer *buffer_;      // the thread's buffer if the span is recorded
+    trace_event   event_;
+};
+#else
+class trace_span
+{
+  public:
+    CDMH_CONSTEXPR trace_span(trace_event::phase_id, char const *, size_t)
+    {
+    }
+};
+#endif
+
+}   // namespace detail
+
+class sort_trace
+{
+  public:
+    // record the spans of subranges of at least min_size elements, discarding the
+    // events recorded before. no traced sort may be running on any thread
+    static void start(size_t min_size=detail::sort_trace_min_size)
+    {
+        auto &state = detail::trace_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (auto buffer : state.buffers)
+            buffer->events().clear();
+        state.retired.clear();
+        state.origin   = detail::trace_clock();
+        state.min_size = std::max<size_t>(min_size, 1);
+    }
+
+    // stop recording; the spans that are open are recorded when they end
+    static void stop()
+    {
+        detail::trace_state().min_size = SIZE_MAX;
+    }
+
+    // the events recorded by all threads, in the order they started, parents first
+    static std::vector<trace_event> events()
+    {
+        auto &state = detail::trace_state();
+        std::vector<trace_event> events;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            events = state.retired;
+            for (auto buffer : state.buffers)
+                events.insert(events.end(), buffer->events().begin(), buffer->events().end());
+        }
+
+        std::sort(events.begin(), events.end(), [](trace_event const &first, trace_event const &second) {
+            return (first.start != second.start)? first.start < second.start : first.depth < second.depth;
+        });
+        return events;
+    }
+
+    // write the events as complete ("X") events of a Chrome trace_event JSON file, in
+    // microseconds; false if the file can't be written
+    static bool write(char const *path)
+    {
+        std::FILE *file = std::fopen(path, "w");
+        if (file == nullptr)
+            return false;
+
+        auto const events = sort_trace::events();
+        std::fputs("{\"traceEvents\":[", file);
+        for (size_t loop=0; loop<events.size(); ++loop)
+        {
+            auto const &event = events[loop];
+            auto const duration = event.end - event.start;
+            std::fprintf(file,
+                "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"pid\":1,\"tid\":%u,\"args\":{\"depth\":%u,\"size\":%llu}}",
+                (loop == 0)? "" : ",",
+                event.name, trace_event::phase_name(trace_event::phase_id(event.phase)),
+                (unsigned long long)(event.start / 1000), unsigned(event.start % 1000),
+                (unsigned long long)(duration / 1000), unsigned(duration % 1000),
+                unsigned(event.thread), unsigned(event.depth), (unsigned long long)event.size);
+        }
+        std::fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+        return std::fclose(file) == 0;
+    }
+};
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -0,0 +1,160 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "insertion_sort.h"
+#include "introsort.detail.h"
+#include "nth_element.h"        // introselect_depth
+
+namespace cdmh {
+
+// Sort Unique, Sort Reduce by Key
+//     Worst case performance       O(n log u) expected for u distinct keys
+//     Worst case space complexity  O(log n) auxiliary
+//
+// sorts a range and collapses each run of equivalent elements to one element as the
+// runs are found, returning the end of the collapsed range. the range is divided as
+// in introsort by quicksort_splits, which leaves the elements equivalent to the pivot
+// in a block of their own; that block is collapsed at once and never partitioned
+// again, so duplicate-heavy data does far less work than a sort followed by a pass
+// of std::unique. sort_unique keeps one element of each run, and
+// sort_reduce_by_key folds each run into one element with reduce(into, std::move(from)),
+// which must not depend on the order the elements are folded in. merge_unique and
+// merge_reduce_by_key merge two collapsed ranges, collapsing equivalent elements
+// while merging. bidirectional iterators are sufficient
+
+namespace detail {
+
+// segments of this size or smaller are collapsed after an insertion sort
+size_t const sort_unique_threshold = 16;
+
+// the reduction of sort_unique discards all but one element of a run
+struct discard_duplicate
+{
+    template<typename T, typename U>
+    void operator()(T &, U &&) const
+    {
+    }
+};
+
+// collapse runs of equivalent elements in a sorted range, returning the new end
+template<typename It, typename Pred, typename Reduce>
+inline It reduce_adjacent(It begin, It end, Pred &pred, Reduce &reduce)
+{
+    if (begin == end)
+        return end;
+
+    It out = begin;
+    for (It it=begin; ++it != end; )
+    {
+        if (pred(*out, *it))
+        {
+            if (++out != it)
+                *out = std::move(*it);
+        }
+        else
+            reduce(*out, std::move(*it));
+    }
+    return ++out;
+}
+
+template<typename It, typename Pred, typename Reduce>
+inline It sort_reduce(It begin, It end, Pred &pred, Reduce &reduce, size_t depth)
+{
+    if (size_t(std::distance(begin, end)) <= sort_unique_threshold)
+    {
+        cdmh::insertion_sort(begin, end, pred);
+        return detail::reduce_adjacent(begin, end, pred, reduce);
+    }
+    else if (--depth == 0  &&  heap_sort_if_we_can<It>()(begin, end, pred))
+        return detail::reduce_adjacent(begin, end, pred, reduce);
+
+    auto const splits = detail::quicksort_splits(begin, end, pred);
+
+    // the elements less than the pivot are collapsed first, then the block equivalent
+    // to the pivot becomes one element after them, then the greater elements follow
+    It out = detail::sort_reduce(begin, splits.first, pred, reduce, depth);
+    for (It it=splits.first; ++it != splits.second; )
+        reduce(*splits.first, std::move(*it));
+    if (out != splits.first)
+        *out = std::move(*splits.first);
+    ++out;
+
+    It const greater = detail::sort_reduce(splits.second, end, pred, reduce, depth);
+    return (out == splits.second)? greater : std::move(splits.second, greater, out);
+}
+
+template<typename It1, typename It2, typename Out, typename Pred, typename Reduce>
+inline Out merge_reduce(It1 first1, It1 last1, It2 first2, It2 last2, Out result, Pred &pred, Reduce &reduce)
+{
+    while (first1 != last1  &&  first2 != last2)
+    {
+        if (pred(*first2, *first1))
+            *result++ = std::move(*first2++);
+        else if (pred(*first1, *first2))
+            *result++ = std::move(*first1++);
+        else
+        {
+            reduce(*first1, std::move(*first2++));
+            *result++ = std::move(*first1++);
+        }
+    }
+    result = std::move(first1, last1, result);
+    return std::move(first2, last2, result);
+}
+
+}   // namespace detail
+
+template<typename It, typename Pred, typename Reduce>
+inline It sort_reduce_by_key(It begin, It end, Pred pred, Reduce reduce)
+{
+    auto const size = std::distance(begin, end);
+    if (size <= 1)
+        return end;
+
+    auto const range = detail::kernel_range(begin, end);
+    auto const last  = detail::sort_reduce(range.first, range.second, pred, reduce, detail::introselect_depth(size));
+    return detail::kernel<It>::from(begin, range.first, last);
+}
+
+template<typename It, typename Pred=std::less<typename std::iterator_traits<It>::value_type>>
+inline It sort_unique(It begin, It end, Pred pred=Pred())
+{
+    return cdmh::sort_reduce_by_key(begin, end, pred, detail::discard_duplicate());
+}
+
+// merge two sorted and collapsed ranges, folding elements of the second range into
+// equivalent elements of the first. the elements are moved to the output
+template<typename It1, typename It2, typename Out, typename Pred, typename Reduce>
+inline Out merge_reduce_by_key(It1 first1, It1 last1, It2 first2, It2 last2, Out result, Pred pred, Reduce reduce)
+{
+    return detail::merge_reduce(first1, last1, first2, last2, result, pred, reduce);
+}
+
+template<typename It1, typename It2, typename Out, typename Pred=std::less<typename std::iterator_traits<It1>::value_type>>
+inline Out merge_unique(It1 first1, It1 last1, It2 first2, It2 last2, Out result, Pred pred=Pred())
+{
+    return cdmh::merge_reduce_by_key(first1, last1, first2, last2, result, pred, detail::discard_duplicate());
+}
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
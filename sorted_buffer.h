@@ -0,0 +1,286 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "introsort.h"
+#include <algorithm>    // lower_bound, upper_bound, move_backward
+#include <vector>
+
+namespace cdmh {
+
+// Sorted Buffer
+//     insert                       O(log n) amortised
+//     lower_bound, iteration       O(1) amortised flush, then O(log n)
+//     contains                     O(log^2 n) without flushing
+//     Space complexity             O(n)
+//
+// a sorted multiset held in one vector that takes bursts of inserts cheaply. inserts
+// are appended to an unsorted tail; when the tail reaches a threshold it is sorted
+// with introsort and becomes a run. the vector holds a sequence of sorted runs, each
+// less than half the size of the one before it, as in the tiers of a log-structured
+// merge tree: when the last run is at least half the size of the run before it, the two
+// are merged, so each element takes part in O(log n) merges. runs are merged with a
+// galloping merge, which moves blocks of elements found with an exponential search
+// once one run has supplied several elements in a row. contains() searches each run
+// and the tail without merging anything; reading in order with begin(), end(),
+// lower_bound(), upper_bound() or [] first merges everything into a single run
+
+namespace detail {
+
+// number of unsorted elements in the tail before it is sorted into a run
+size_t const sorted_buffer_tail = 256;
+
+// number of elements a run must supply in a row before the merge starts galloping
+size_t const gallop_threshold = 7;
+
+// the first element of [begin, end) greater than value, searching back from the end
+template<typename It, typename T, typename Pred>
+inline It gallop_upper_bound(It begin, It end, T const &value, Pred &pred)
+{
+    // elements from `hi` onwards are known to be greater than value
+    It hi = end;
+    size_t step = 1;
+    while (size_t(hi - begin) > step  &&  pred(value, *(hi - step)))
+    {
+        hi -= step;
+        step *= 2;
+    }
+    return std::upper_bound((size_t(hi - begin) > step)? hi - step : begin, hi, value, pred);
+}
+
+// the first element of [begin, end) not less than value, searching back from the end
+template<typename It, typename T, typename Pred>
+inline It gallop_lower_bound(It begin, It end, T const &value, Pred &pred)
+{
+    It hi = end;
+    size_t step = 1;
+    while (size_t(hi - begin) > step  &&  !pred(*(hi - step), value))
+    {
+        hi -= step;
+        step *= 2;
+    }
+    return std::lower_bound((size_t(hi - begin) > step)? hi - step : begin, hi, value, pred);
+}
+
+// stable merge of the adjacent sorted runs [begin, middle) and [middle, end), merging
+// from the back with the second run moved out to a buffer
+template<typename It, typename T, typename Pred>
+inline void gallop_merge(It begin, It middle, It end, std::vector<T> &buffer, Pred &pred)
+{
+    buffer.assign(std::make_move_iterator(middle), std::make_move_iterator(end));
+
+    It   out    = end;
+    It   left   = middle;
+    auto right  = buffer.end();
+    while (left != begin  &&  right != buffer.begin())
+    {
+        // take one element at a time until one run supplies several in a row
+        size_t left_wins  = 0;
+        size_t right_wins = 0;
+        while (left != begin  &&  right != buffer.begin()  &&  left_wins < gallop_threshold  &&  right_wins < gallop_threshold)
+        {
+            if (pred(*(right - 1), *(left - 1)))
+            {
+                *--out = std::move(*--left);
+                ++left_wins;
+                right_wins = 0;
+            }
+            else
+            {
+                *--out = std::move(*--right);
+                ++right_wins;
+                left_wins = 0;
+            }
+        }
+        if (left == begin  ||  right == buffer.begin())
+            break;
+
+        // then move the whole block of elements that come after the other run's last
+        if (left_wins != 0)
+        {
+            It const from = detail::gallop_upper_bound(begin, left, *(right - 1), pred);
+            out  = std::move_backward(from, left, out);
+            left = from;
+        }
+        else
+        {
+            auto const from = detail::gallop_lower_bound(buffer.begin(), right, *(left - 1), pred);
+            out   = std::move_backward(from, right, out);
+            right = from;
+        }
+    }
+    std::move_backward(buffer.begin(), right, out);
+    buffer.clear();
+}
+
+}   // namespace detail
+
+template<typename T, typename Pred=std::less<T>>
+class sorted_buffer
+{
+  public:
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    explicit sorted_buffer(Pred pred=Pred(), size_t tail=detail::sorted_buffer_tail)
+      : pred_(pred),
+        tail_(std::max<size_t>(tail, 1))
+    {
+    }
+
+    void insert(T const &value)
+    {
+        values_.push_back(value);
+        if (values_.size() - sorted() >= tail_)
+            seal();
+    }
+
+    void insert(T &&value)
+    {
+        values_.push_back(std::move(value));
+        if (values_.size() - sorted() >= tail_)
+            seal();
+    }
+
+    template<typename It>
+    void insert(It begin, It end)
+    {
+        for (; begin!=end; ++begin)
+            insert(*begin);
+    }
+
+    bool contains(T const &value) const
+    {
+        size_t run_begin = 0;
+        for (auto const run_end : runs_)
+        {
+            auto const it = std::lower_bound(values_.begin() + run_begin, values_.begin() + run_end, value, pred_);
+            if (it != values_.begin() + run_end  &&  !pred_(value, *it))
+                return true;
+            run_begin = run_end;
+        }
+        return std::any_of(values_.begin() + run_begin, values_.end(), [this, &value](T const &element) {
+            return !pred_(element, value)  &&  !pred_(value, element);
+        });
+    }
+
+    // merge the tail and all the runs into a single sorted run
+    void flush()
+    {
+        seal();
+        while (runs_.size() > 1)
+            merge_last_runs();
+    }
+
+    const_iterator begin()
+    {
+        flush();
+        return values_.begin();
+    }
+
+    const_iterator end()
+    {
+        flush();
+        return values_.end();
+    }
+
+    const_iterator lower_bound(T const &value)
+    {
+        flush();
+        return std::lower_bound(values_.begin(), values_.end(), value, pred_);
+    }
+
+    const_iterator upper_bound(T const &value)
+    {
+        flush();
+        return std::upper_bound(values_.begin(), values_.end(), value, pred_);
+    }
+
+    T const &operator[](size_t index)
+    {
+        flush();
+        return values_[index];
+    }
+
+    size_t size() const
+    {
+        return values_.size();
+    }
+
+    bool empty() const
+    {
+        return values_.empty();
+    }
+
+    // number of sorted runs, which is one after a flush
+    size_t runs() const
+    {
+        return runs_.size();
+    }
+
+    void clear()
+    {
+        values_.clear();
+        runs_.clear();
+    }
+
+  private:
+    size_t sorted() const
+    {
+        return runs_.empty()? 0 : runs_.back();
+    }
+
+    // sort the tail into a new run, merging it with the runs before it until it is less
+    // than half the size of the run before it
+    void seal()
+    {
+        if (values_.size() == sorted())
+            return;
+
+        cdmh::introsort(values_.begin() + sorted(), values_.end(), pred_);
+        runs_.push_back(values_.size());
+        while (runs_.size() > 1)
+        {
+            size_t const last     = runs_.back() - runs_[runs_.size() - 2];
+            size_t const previous = runs_[runs_.size() - 2] - ((runs_.size() > 2)? runs_[runs_.size() - 3] : 0);
+            if (2 * last < previous)
+                break;
+            merge_last_runs();
+        }
+    }
+
+    void merge_last_runs()
+    {
+        auto const begin  = values_.begin() + ((runs_.size() > 2)? runs_[runs_.size() - 3] : 0);
+        auto const middle = values_.begin() + runs_[runs_.size() - 2];
+        detail::gallop_merge(begin, middle, values_.begin() + runs_.back(), buffer_, pred_);
+        runs_.erase(runs_.end() - 2);
+    }
+
+    Pred                pred_;
+    size_t              tail_;
+    std::vector<T>      values_;    // sorted runs, followed by the unsorted tail
+    std::vector<size_t> runs_;      // end of each sorted run
+    std::vector<T>      buffer_;    // scratch space for merging runs
+};
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
@@ -1,17 +1,47 @@
 // Copyright (c) 2013 Craig Henderson
 // https://github.com/cdmh/sorting_algorithms
 
+// the tests run with the hooks of the sort sampler and sort trace compiled in
+#define CDMH_SORT_SAMPLING
+#define CDMH_SORT_TRACING
+
+#include "batch_sort.h"
+#include "block_merge_sort.h"
 #include "bubble_sort.h"
 #include "cocktail_sort.h"
+#include "counting_sort.h"
+#include "deque_sort.h"
 #include "heap_sort.h"
 #include "insertion_sort.h"
 #include "introsort.h"
+#include "kway_merge.h"
+#include "lazy_sorted_view.h"
+#include "merge_join.h"
 #include "merge_sort.h"
 #include "minmax_sort.h"
+#include "multiway_merge_sort.h"
+#include "normalized_key.h"
+#include "nth_element.h"
+#include "parallel_sort.h"
+#include "partial_sort.h"
+#include "perf_counters.h"
 #include "quicksort.h"
+#include "resort_dirty.h"
+#include "scratch.h"
+#include "segmented_sort.h"
 #include "selection_sort.h"
+#include "sort_sampler.h"
+#include "sort_task.h"
+#include "sort_trace.h"
+#include "sort_unique.h"
+#include "sorted_buffer.h"
+#include "topk_accumulator.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include "record_sort.h"
+#endif
 
 #include <algorithm>    // is_sorted
+#include <atomic>
 #include <functional>   // greater
 #include <cassert>
 #include <string>
@@ -19,6 +49,69 @@
 #include <deque>
 #include <iostream>
 #include <chrono>
+#include <mutex>
+#include <thread>
+#include <cmath>        // nan, HUGE_VAL
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>       // unique_ptr
+
+// contiguous ranges are sorted through pointers, others through their iterators
+static_assert(cdmh::is_contiguous_iterator<int *>::value, "pointers are contiguous");
+static_assert(cdmh::is_contiguous_iterator<std::vector<int>::iterator>::value, "vector iterators are contiguous");
+static_assert(cdmh::is_contiguous_iterator<std::vector<std::string>::const_iterator>::value, "vector iterators are contiguous");
+static_assert(!cdmh::is_contiguous_iterator<std::vector<bool>::iterator>::value, "vector<bool> iterators are not contiguous");
+static_assert(!cdmh::is_contiguous_iterator<std::deque<int>::iterator>::value, "deque iterators are not contiguous");
+static_assert(!cdmh::is_contiguous_iterator<std::list<int>::iterator>::value, "list iterators are not contiguous");
+
+#if CDMH_HAS_CONSTEXPR_SORT
+#include <array>
+#include <string_view>
+
+// from C++20 the core algorithms sort at compile time, so tables can be built sorted
+namespace constexpr_sorts {
+
+// a table with duplicates, long enough for introsort to fall back to heap sort
+template<typename Sort>
+constexpr std::array<int, 200> sorted_table(Sort sort)
+{
+    std::array<int, 200> table{};
+    for (size_t loop=0; loop<table.size(); ++loop)
+        table[loop] = int((loop * 37 + 11) % 53);
+    sort(table.begin(), table.end());
+    return table;
+}
+
+constexpr auto insertion = sorted_table([](auto begin, auto end) { cdmh::insertion_sort(begin, end); });
+constexpr auto heap      = sorted_table([](auto begin, auto end) { cdmh::heap_sort(begin, end); });
+constexpr auto quick     = sorted_table([](auto begin, auto end) { cdmh::quicksort(begin, end, std::greater<int>()); });
+constexpr auto intro     = sorted_table([](auto begin, auto end) { cdmh::introsort(begin, end); });
+constexpr auto merge     = sorted_table([](auto begin, auto end) { cdmh::merge_sort(begin, end); });
+static_assert(std::is_sorted(insertion.begin(), insertion.end()), "insertion_sort is constexpr");
+static_assert(std::is_sorted(heap.begin(), heap.end()), "heap_sort is constexpr");
+static_assert(std::is_sorted(quick.begin(), quick.end(), std::greater<int>()), "quicksort is constexpr");
+static_assert(std::is_sorted(intro.begin(), intro.end()), "introsort is constexpr");
+static_assert(std::is_sorted(merge.begin(), merge.end()), "merge_sort is constexpr");
+
+// a name to value map sorted stably by name, for binary searches at run time
+struct named
+{
+    std::string_view name;
+    int              value;
+};
+
+constexpr auto names = [] {
+    std::array<named, 6> table{{ { "red", 0 }, { "green", 1 }, { "blue", 2 }, { "cyan", 3 }, { "blue", 4 }, { "amber", 5 } }};
+    cdmh::merge_sort(table.begin(), table.end(), [](named const &first, named const &second) {
+        return first.name < second.name;
+    });
+    return table;
+}();
+static_assert(names[0].name == "amber"  &&  names[1].value == 2  &&  names[2].value == 4  &&  names[5].name == "red", "stable sort of a table at compile time");
+
+}   // namespace constexpr_sorts
+#endif
 
 namespace cdmh {
 namespace test {
@@ -67,14 +160,97 @@ bool const matching_containers(C const &container, C const &expected)
     return (container == expected);
 }
 
+// run a sort of `size` elements and report the hardware counters per element, if
+// there are counters, as there are when enabled with --counters
+template<typename Sort>
+void counted(cdmh::perf_counters *counters, size_t size, Sort sort)
+{
+    if (counters == nullptr)
+    {
+        sort();
+        return;
+    }
+
+    counters->start();
+    sort();
+    counters->stop();
+
+    std::clog << "    per element:";
+    for (int c=0; c<cdmh::perf_counters::counter_count; ++c)
+    {
+        auto const counter = cdmh::perf_counters::counter(c);
+        if (counters->available(counter))
+            std::clog << ' ' << cdmh::perf_counters::name(counter) << ' ' << double(counters->value(counter)) / std::max<size_t>(size, 1);
+    }
+    std::clog << '\n';
+}
+
+// an allocator that counts the allocations made on threads other than the one that
+// created it, as an allocator such as an arena is not thread safe
+template<typename T>
+class calling_thread_allocator
+{
+  public:
+    using value_type = T;
+
+    explicit calling_thread_allocator(std::atomic<size_t> &foreign)
+      : thread_(std::this_thread::get_id()), foreign_(&foreign)
+    {
+    }
+
+    template<typename U>
+    calling_thread_allocator(calling_thread_allocator<U> const &other)
+      : thread_(other.thread()), foreign_(&other.foreign())
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        if (std::this_thread::get_id() != thread_)
+            ++*foreign_;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T *p, size_t count)
+    {
+        std::allocator<T>().deallocate(p, count);
+    }
+
+    std::thread::id thread() const
+    {
+        return thread_;
+    }
+
+    std::atomic<size_t> &foreign() const
+    {
+        return *foreign_;
+    }
+
+  private:
+    std::thread::id      thread_;
+    std::atomic<size_t> *foreign_;
+};
+
+template<typename T, typename U>
+inline bool operator==(calling_thread_allocator<T> const &first, calling_thread_allocator<U> const &second)
+{
+    return &first.foreign() == &second.foreign();
+}
+
+template<typename T, typename U>
+inline bool operator!=(calling_thread_allocator<T> const &first, calling_thread_allocator<U> const &second)
+{
+    return !(first == second);
+}
+
 }   // namespace utils
 
 namespace wrappers {
 
 template<typename Sort, typename It, typename Pred>
-void sort_between_iterators(It it, It ite, Sort sort, Pred pred)
+void sort_between_iterators(It it, It ite, Sort sort, Pred pred, cdmh::perf_counters *counters)
 {
-    sort(it, ite, pred);
+    utils::counted(counters, std::distance(it, ite), [&]() { sort(it, ite, pred); });
     std::clog << "--> ";
     utils::dump(it, ite);
     std::clog << '\n';
@@ -82,10 +258,10 @@ void sort_between_iterators(It it, It ite, Sort sort, Pred pred)
 }
 
 template<typename Sort, typename C, typename Pred>
-void sort_container(Sort sort, C container, Pred pred)
+void sort_container(Sort sort, C container, Pred pred, cdmh::perf_counters *counters)
 {
     C expected(utils::sorted(container, pred));
-    sort(container.begin(), container.end(), pred);
+    utils::counted(counters, container.size(), [&]() { sort(container.begin(), container.end(), pred); });
 
     std::clog << "--> ";
     utils::dump(container.begin(), container.end());
@@ -95,11 +271,11 @@ void sort_container(Sort sort, C container, Pred pred)
 }
 
 template<typename Sort, typename C, typename Pred>
-void sort_container_copy(Sort sort, C container, Pred pred)
+void sort_container_copy(Sort sort, C container, Pred pred, cdmh::perf_counters *counters)
 {
     C result;
     C expected(utils::sorted(container, pred));
-    sort(container.begin(), container.end(), std::back_inserter(result), pred);
+    utils::counted(counters, container.size(), [&]() { sort(container.begin(), container.end(), std::back_inserter(result), pred); });
 
     std::clog << "--> ";
     utils::dump(result.begin(), result.end());
@@ -108,29 +284,264 @@ void sort_container_copy(Sort sort, C container, Pred pred)
     assert(utils::matching_containers(result, expected));
 }
 
+template<typename Select, typename C, typename Pred>
+void select_container(Select select, C container, size_t nth, Pred pred, cdmh::perf_counters *counters)
+{
+    C expected(utils::sorted(container, pred));
+    auto const it = cdmh::detail::advance(container.begin(), nth);
+    utils::counted(counters, container.size(), [&]() { select(container.begin(), it, container.end(), pred); });
+
+    std::clog << "--> ";
+    utils::dump(container.begin(), container.end());
+    std::clog << '\n';
+
+    auto const &value = *cdmh::detail::advance(expected.begin(), nth);
+    assert(!pred(*it, value)  &&  !pred(value, *it));
+    assert(std::none_of(container.begin(), it, [&](typename C::value_type const &v) { return pred(*it, v); }));
+    assert(std::none_of(it, container.end(), [&](typename C::value_type const &v) { return pred(v, *it); }));
+    assert(std::is_permutation(container.begin(), container.end(), expected.begin()));
+}
+
+template<typename Sort, typename C, typename Pred>
+void partial_sort_container(Sort sort, C container, size_t k, Pred pred, cdmh::perf_counters *counters)
+{
+    C expected(utils::sorted(container, pred));
+    auto const middle = cdmh::detail::advance(container.begin(), k);
+    utils::counted(counters, container.size(), [&]() { sort(container.begin(), middle, container.end(), pred); });
+
+    std::clog << "--> ";
+    utils::dump(container.begin(), middle);
+    std::clog << '\n';
+
+    assert(std::equal(container.begin(), middle, expected.begin(), [&pred](typename C::value_type const &a, typename C::value_type const &b) {
+        return !pred(a, b)  &&  !pred(b, a);
+    }));
+    assert(std::is_permutation(container.begin(), container.end(), expected.begin()));
+}
+
 }   // namespace wrappers
 
 namespace algorithms {
 
 using ::cdmh::test::wrappers::sort_container;
 using ::cdmh::test::wrappers::sort_container_copy;
+using ::cdmh::test::wrappers::select_container;
+using ::cdmh::test::wrappers::partial_sort_container;
+
+template<typename C, typename Pred>
+void batch_sort(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    // the batch sort requires random access iterators, so list is not tested here
+    std::clog << "Batch Sort " << container.size() << " elements \n";
+
+    // segments of increasing size, with whatever remains in the last segment
+    std::vector<size_t> offsets(1, 0);
+    while (offsets.back() + offsets.size() < container.size())
+        offsets.push_back(offsets.back() + offsets.size() - 1);
+    offsets.push_back(container.size());
+
+    for (unsigned threads : { 1, 3 })
+    {
+        std::vector<typename C::value_type> values(container.begin(), container.end());
+        utils::counted(counters, values.size(), [&]() { cdmh::batch_sort(values.begin(), offsets.begin(), offsets.end(), pred, threads); });
+        for (size_t segment=0; segment+1<offsets.size(); ++segment)
+        {
+            std::vector<typename C::value_type> expected(container.begin() + offsets[segment], container.begin() + offsets[segment + 1]);
+            std::sort(expected.begin(), expected.end(), pred);
+            assert(std::equal(expected.begin(), expected.end(), values.begin() + offsets[segment]));
+        }
+
+        std::clog << "--> ";
+        utils::dump(values.begin(), values.end());
+        std::clog << '\n';
+    }
+
+    // the order of the segments, and its copy, come from an arena
+    std::vector<typename C::value_type> values(container.begin(), container.end());
+    cdmh::arena arena;
+    cdmh::batch_sort(values.begin(), offsets.begin(), offsets.end(), pred, 1, cdmh::arena_allocator<char>(arena));
+    assert(arena.used() == (2 * (cdmh::detail::batch_sort_network_max + 3) + offsets.size() - 1) * sizeof(size_t));
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::batch_sort(container.begin(), offsets.begin(), offsets.end());
+}
+
+// segments of every size up to the largest sorted by a network, and one larger, in
+// groups of five so that each size is sorted both four at a time and on its own.
+// scalar elements are exchanged without branches and others are swapped
+template<typename T, typename Make>
+void batch_sort_networks(Make make)
+{
+    std::clog << "Batch Sort networks of up to " << cdmh::detail::batch_sort_network_max << " elements\n";
+    std::vector<T> values;
+    std::vector<size_t> offsets(1, 0);
+    for (size_t size=0; size<=cdmh::detail::batch_sort_network_max+1; ++size)
+    {
+        for (size_t segment=0; segment<5; ++segment)
+        {
+            for (size_t loop=0; loop<size; ++loop)
+                values.push_back(make(std::rand() % (size + 1)));
+            offsets.push_back(values.size());
+        }
+    }
+
+    for (bool const ascending : { true, false })
+    {
+        auto const pred = [ascending](T const &first, T const &second) {
+            return ascending? first < second : second < first;
+        };
+        std::vector<T> sorted(values);
+        cdmh::batch_sort(sorted.begin(), offsets.begin(), offsets.end(), pred);
+        for (size_t segment=0; segment+1<offsets.size(); ++segment)
+        {
+            std::vector<T> expected(values.begin() + offsets[segment], values.begin() + offsets[segment + 1]);
+            std::sort(expected.begin(), expected.end(), pred);
+            assert(std::equal(expected.begin(), expected.end(), sorted.begin() + offsets[segment]));
+        }
+    }
+}
+
+// random segments of 8 to 64 integers, the sizes sorted by networks, against loops
+// of insertion_sort and std::sort over the segments, in segments per second
+void batch_sort_timed(size_t segments)
+{
+    std::vector<size_t> offsets(1, 0);
+    for (size_t segment=0; segment<segments; ++segment)
+        offsets.push_back(offsets.back() + 8 + std::rand() % 57);
+    std::vector<int> container(offsets.back());
+    for (auto &value : container)
+        value = std::rand();
+    std::vector<int> inserted(container);
+    std::vector<int> sorted(container);
+
+    auto const start = std::chrono::steady_clock::now();
+    cdmh::batch_sort(container.begin(), offsets.begin(), offsets.end());
+    auto const batch = std::chrono::steady_clock::now();
+    for (size_t segment=0; segment<segments; ++segment)
+        cdmh::insertion_sort(inserted.begin() + offsets[segment], inserted.begin() + offsets[segment + 1]);
+    auto const insertion = std::chrono::steady_clock::now();
+    for (size_t segment=0; segment<segments; ++segment)
+        std::sort(sorted.begin() + offsets[segment], sorted.begin() + offsets[segment + 1]);
+    auto const finish = std::chrono::steady_clock::now();
+    assert(container == sorted  &&  inserted == sorted);
+
+    using seconds = std::chrono::duration<double>;
+    std::clog << "Batch Sort " << segments << " segments of 8 to 64 integers: "
+              << segments / seconds(batch - start).count() << " segments/s, against insertion_sort "
+              << segments / seconds(insertion - batch).count() << " segments/s and std::sort "
+              << segments / seconds(finish - insertion).count() << " segments/s" << std::endl;
+}
+
+template<typename C, typename Pred>
+void block_merge_sort(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    // the block merge sort requires random access iterators, so list is not tested here
+    std::clog << "Block Merge Sort " << container.size() << " elements\n";
+    sort_container(
+        [](typename std::vector<typename C::value_type>::iterator begin, typename std::vector<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::block_merge_sort(begin, end, pred);
+        },
+        std::vector<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+    sort_container(
+        [](typename std::deque<typename C::value_type>::iterator begin, typename std::deque<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::block_merge_sort(begin, end, pred);
+        },
+        std::deque<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+
+    // with a cache supplied by the caller, smaller than the blocks of the larger merges
+    sort_container(
+        [](typename std::vector<typename C::value_type>::iterator begin, typename std::vector<typename C::value_type>::iterator end, Pred pred) {
+            std::vector<typename C::value_type> cache(8);
+            cdmh::block_merge_sort(begin, end, pred, cache.data(), cache.size());
+        },
+        std::vector<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::block_merge_sort(container.begin(), container.end());
+}
+
+// a block merge sort of `size` elements with few distinct keys, without a cache and
+// with caches smaller and larger than the blocks, against std::stable_sort. a moved
+// from element is poisoned, so comparing one, or leaving one in the result, fails
+void block_merge_sort_stability(size_t size)
+{
+    std::clog << "Block Merge Sort stability " << size << " elements\n";
+    struct element
+    {
+        element() : key(0), index(0), moved(true) { }
+        element(int key, size_t index) : key(key), index(index), moved(false) { }
+        element(element const &other) = default;
+        element(element &&other) : key(other.key), index(other.index), moved(other.moved) { other.moved = true; }
+        element &operator=(element const &other) = default;
+        element &operator=(element &&other)
+        {
+            if (this != &other)
+            {
+                key   = other.key;
+                index = other.index;
+                moved = other.moved;
+                other.moved = true;
+            }
+            return *this;
+        }
+
+        int    key;
+        size_t index;
+        bool   moved;
+    };
+    auto const less = [](element const &first, element const &second) {
+        assert(!first.moved  &&  !second.moved);
+        return first.key < second.key;
+    };
+
+    std::vector<element> container;
+    for (size_t loop=0; loop<size; ++loop)
+        container.push_back(element(std::rand() % 7, loop));
+    std::vector<element> expected(container);
+    std::stable_sort(expected.begin(), expected.end(), less);
+    auto const same = [](element const &first, element const &second) {
+        return !first.moved  &&  first.index == second.index;
+    };
+
+    std::vector<element> values(container);
+    cdmh::block_merge_sort(values.begin(), values.end(), less);
+    assert(std::equal(values.begin(), values.end(), expected.begin(), same));
+    for (size_t cache_size : { 8, 512, 4096 })
+    {
+        std::vector<element> cache(cache_size);
+        values = container;
+        cdmh::block_merge_sort(values.begin(), values.end(), less, cache.data(), cache.size());
+        assert(std::equal(values.begin(), values.end(), expected.begin(), same));
+    }
+}
 
 template<typename C, typename Pred>
-void bubble_sort(C container, Pred pred)
+void bubble_sort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Bubble Sort " << container.size() << " elements \n";
     sort_container(
         cdmh::bubble_sort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::bubble_sort<typename std::list<typename C::value_type>::iterator, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::bubble_sort<typename std::deque<typename C::value_type>::iterator, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
@@ -138,29 +549,205 @@ void bubble_sort(C container, Pred pred)
 }
 
 template<typename C, typename Pred>
-void cocktail_sort(C container, Pred pred)
+void cocktail_sort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Cocktail Sort " << container.size() << " elements \n";
     sort_container(
         cdmh::cocktail_sort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::cocktail_sort<typename std::list<typename C::value_type>::iterator, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::cocktail_sort<typename std::deque<typename C::value_type>::iterator, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
     cdmh::cocktail_sort(container.begin(), container.end());
 }
 
+template<typename C>
+void counting_sort(C container, cdmh::perf_counters *counters)
+{
+    std::clog << "Counting Sort " << container.size() << " elements \n";
+
+    // sorting by the last digit keeps elements with the same last digit in their order
+    auto const key  = [](int value) { return value % 10; };
+    auto const pred = [&key](int first, int second) { return key(first) < key(second); };
+    std::vector<int> expected(container.begin(), container.end());
+    std::stable_sort(expected.begin(), expected.end(), pred);
+
+    C values(container);
+    utils::counted(counters, values.size(), [&]() { cdmh::counting_sort(values.begin(), values.end(), key); });
+    assert(std::equal(values.begin(), values.end(), expected.begin()));
+
+    values = container;
+    cdmh::counting_sort(values.begin(), values.end(), key, -9, 9);
+    assert(std::equal(values.begin(), values.end(), expected.begin()));
+
+    cdmh::arena arena;
+    values = container;
+    cdmh::counting_sort(values.begin(), values.end(), key, -9, 9, cdmh::arena_allocator<int>(arena));
+    assert(std::equal(values.begin(), values.end(), expected.begin()));
+    assert(container.size() <= 18  ||  arena.used() >= container.size() * sizeof(int) + 20 * sizeof(size_t));
+
+    std::clog << "--> ";
+    utils::dump(values.begin(), values.end());
+    std::clog << '\n';
+
+    // sort_by_key with a small range of keys, and with a range too large to count;
+    // few elements may also have too large a range, and the result is then not stable
+    values = container;
+    cdmh::sort_by_key(values.begin(), values.end(), key);
+    assert(std::is_sorted(values.begin(), values.end(), pred));
+    assert(container.size() < 1000  ||  std::equal(values.begin(), values.end(), expected.begin()));
+
+    values = container;
+    cdmh::sort_by_key(values.begin(), values.end(), [](int value) { return value * 1000; });
+    assert(std::is_sorted(values.begin(), values.end()));
+    assert(std::is_permutation(values.begin(), values.end(), container.begin()));
+
+    // bool keys are counted, and keys whose range is too wide to count are compared
+    values = container;
+    auto const negative = [](int value) { return value < 0; };
+    cdmh::counting_sort(values.begin(), values.end(), negative);
+    std::vector<int> by_sign(container.begin(), container.end());
+    std::stable_partition(by_sign.begin(), by_sign.end(), [&negative](int value) { return !negative(value); });
+    assert(std::equal(values.begin(), values.end(), by_sign.begin()));
+
+    using limits = std::numeric_limits<long long>;
+    std::vector<long long> wide{ limits::max(), limits::min(), 0, 1000000000000, -1, limits::max() };
+    auto const sorted_wide = utils::sorted(wide, std::less<long long>());
+    cdmh::counting_sort(wide.begin(), wide.end());
+    assert(wide == sorted_wide);
+    std::reverse(wide.begin(), wide.end());
+    cdmh::counting_sort(wide.begin(), wide.end(), cdmh::detail::identity_key(), limits::min(), limits::max());
+    assert(wide == sorted_wide);
+
+    // a given range of keys much wider than the number of elements is not counted, so
+    // no histogram is allocated for it
+    std::vector<long long> sparse;
+    for (auto const value : container)
+        sparse.push_back((value + 500) * 1000000000LL);
+    auto const sorted_sparse = utils::sorted(sparse, std::less<long long>());
+    cdmh::arena sparse_arena;
+    cdmh::counting_sort(sparse.begin(), sparse.end(), cdmh::detail::identity_key(), 0LL, 1000000000000LL, cdmh::arena_allocator<long long>(sparse_arena));
+    assert(sparse == sorted_sparse);
+    assert(sparse_arena.used() <= sparse.size() * sizeof(long long));
+
+    // test the interface for default parameters
+    cdmh::counting_sort(container.begin(), container.end());
+    assert(std::is_sorted(container.begin(), container.end()));
+}
+
+// counting sort of values from a small range in containers of each type
+void counting_sorts(cdmh::perf_counters *counters)
+{
+    for (size_t size : { 0, 1, 10, 10000 })
+    {
+        std::vector<int> container(size);
+        for (auto &value : container)
+            value = std::rand() % 1000 - 500;
+        counting_sort(container, counters);
+        counting_sort(std::deque<int>(container.begin(), container.end()), counters);
+        counting_sort(std::list<int>(container.begin(), container.end()), counters);
+    }
+}
+
 template<typename C, typename Pred>
-void heap_sort(C container, Pred pred)
+void deque_sort(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    // the deque sort requires random access iterators, so list is not tested here
+    std::clog << "Deque Sort " << container.size() << " elements \n";
+    for (unsigned threads : { 1, 3 })
+    {
+        sort_container(
+            [threads](typename std::deque<typename C::value_type>::iterator begin, typename std::deque<typename C::value_type>::iterator end, Pred pred) {
+                cdmh::deque_sort(begin, end, pred, threads);
+            },
+            std::deque<typename C::value_type>(container.begin(), container.end()),
+            pred,
+            counters);
+    }
+    sort_container(
+        [](typename std::vector<typename C::value_type>::iterator begin, typename std::vector<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::deque_sort(begin, end, pred);
+        },
+        std::vector<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+
+    // the in-place sorts sort a deque in place, and merge_sort sorts its blocks
+    // through pointers and merges them
+    using deque_iterator = typename std::deque<typename C::value_type>::iterator;
+    std::deque<typename C::value_type> const values(container.begin(), container.end());
+    sort_container(cdmh::introsort<deque_iterator, Pred>, values, pred, counters);
+    sort_container(cdmh::quicksort<deque_iterator, Pred>, values, pred, counters);
+    sort_container(cdmh::heap_sort<deque_iterator, Pred>, values, pred, counters);
+
+    // merging the blocks keeps merge_sort stable
+    using indexed_value = std::pair<typename C::value_type, size_t>;
+    auto const by_value = [&pred](indexed_value const &first, indexed_value const &second) {
+        return pred(first.first, second.first);
+    };
+    std::deque<indexed_value> indexed;
+    for (auto const &value : container)
+        indexed.push_back(indexed_value(value, indexed.size()));
+    std::vector<indexed_value> expected(indexed.begin(), indexed.end());
+    std::stable_sort(expected.begin(), expected.end(), by_value);
+    std::deque<indexed_value> buffered(indexed);
+    cdmh::merge_sort(indexed.begin(), indexed.end(), by_value);
+    cdmh::merge_sort(buffered.begin(), buffered.end(), by_value, std::allocator<indexed_value>());
+    assert(std::equal(indexed.begin(), indexed.end(), expected.begin()));
+    assert(std::equal(buffered.begin(), buffered.end(), expected.begin()));
+
+    // the buffer is move constructed, so the elements need not be default constructible
+    struct without_default
+    {
+        explicit without_default(typename C::value_type const &value) : value(value)
+        {
+        }
+
+        typename C::value_type value;
+    };
+    auto const by_member = [&pred](without_default const &first, without_default const &second) {
+        return pred(first.value, second.value);
+    };
+    auto const check = [&](std::deque<without_default> const &sorted) {
+        assert(std::is_sorted(sorted.begin(), sorted.end(), by_member));
+    };
+    std::deque<without_default> members;
+    for (auto const &value : container)
+        members.push_back(without_default(value));
+    for (unsigned threads : { 1, 3 })
+    {
+        auto sorted(members);
+        cdmh::deque_sort(sorted.begin(), sorted.end(), by_member, threads);
+        check(sorted);
+    }
+    auto merged(members), buffered_members(members), heaped(members), introsorted(members), quicksorted(members);
+    cdmh::merge_sort(merged.begin(), merged.end(), by_member);
+    cdmh::merge_sort(buffered_members.begin(), buffered_members.end(), by_member, std::allocator<without_default>());
+    cdmh::heap_sort(heaped.begin(), heaped.end(), by_member);
+    cdmh::introsort(introsorted.begin(), introsorted.end(), by_member);
+    cdmh::quicksort(quicksorted.begin(), quicksorted.end(), by_member);
+    for (auto const &sorted : { merged, buffered_members, heaped, introsorted, quicksorted })
+        check(sorted);
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::deque_sort(container.begin(), container.end());
+}
+
+template<typename C, typename Pred>
+void heap_sort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     // the heap sort currently uses std::make_heap and std::sort_heap which both require
     // a random access iterator, so only vector is tested here
@@ -168,7 +755,8 @@ void heap_sort(C container, Pred pred)
     sort_container(
         cdmh::heap_sort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
@@ -176,21 +764,24 @@ void heap_sort(C container, Pred pred)
 }
 
 template<typename C, typename Pred>
-void insertion_sort(C container, Pred pred)
+void insertion_sort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Insertion Sort " << container.size() << " elements\n";
     sort_container(
         cdmh::insertion_sort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::insertion_sort<typename std::list<typename C::value_type>::iterator, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::insertion_sort<typename std::deque<typename C::value_type>::iterator, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
@@ -198,21 +789,24 @@ void insertion_sort(C container, Pred pred)
 }
 
 template<typename C, typename Pred>
-void introsort_sort(C container, Pred pred)
+void introsort_sort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Introsort " << container.size() << " elements \n";
     sort_container(
         cdmh::introsort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::introsort<typename std::list<typename C::value_type>::iterator, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::introsort<typename std::deque<typename C::value_type>::iterator, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
@@ -220,7 +814,208 @@ void introsort_sort(C container, Pred pred)
 }
 
 template<typename C, typename Pred>
-void merge_sort_copy(C container, Pred pred)
+void kway_merge(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    std::clog << "K-way Merge " << container.size() << " elements\n";
+
+    // cut the data into sorted runs of increasing length, starting with an empty run
+    using vector_t = std::vector<typename C::value_type>;
+    vector_t values(container.begin(), container.end());
+    std::vector<std::pair<typename vector_t::iterator, typename vector_t::iterator>> runs;
+    for (auto it=values.begin(); runs.empty()  ||  it!=values.end(); )
+    {
+        auto const ite = it + std::min<ptrdiff_t>(runs.size(), values.end() - it);
+        std::stable_sort(it, ite, pred);
+        runs.push_back(std::make_pair(it, ite));
+        it = ite;
+    }
+
+    vector_t expected(values);
+    std::stable_sort(expected.begin(), expected.end(), pred);
+
+    vector_t result;
+    utils::counted(counters, values.size(), [&]() { cdmh::kway_merge(runs.begin(), runs.end(), std::back_inserter(result), pred); });
+    std::clog << "--> ";
+    utils::dump(result.begin(), result.end());
+    std::clog << '\n';
+    assert(utils::matching_containers(result, expected));
+
+    vector_t parallel_result(values.size());
+    utils::counted(counters, values.size(), [&]() { cdmh::parallel_kway_merge(runs.begin(), runs.end(), parallel_result.begin(), pred, 4); });
+    assert(utils::matching_containers(parallel_result, expected));
+
+    // test the interface for default parameters
+    std::random_shuffle(values.begin(), values.end());
+    std::sort(values.begin(), values.end());
+    runs.assign(1, std::make_pair(values.begin(), values.end()));
+    result.clear();
+    cdmh::kway_merge(runs.begin(), runs.end(), std::back_inserter(result));
+    cdmh::parallel_kway_merge(runs.begin(), runs.end(), parallel_result.begin());
+}
+
+template<typename C, typename Pred>
+void merge_join(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    std::clog << "Merge Join " << container.size() << " elements\n";
+
+    // join the sorted first half of the data with the sorted second half
+    using vector_t = std::vector<typename C::value_type>;
+    using iterator_t = typename vector_t::const_iterator;
+    vector_t left(container.begin(), container.begin() + container.size() / 2);
+    vector_t right(container.begin() + container.size() / 2, container.end());
+    std::sort(left.begin(), left.end(), pred);
+    std::sort(right.begin(), right.end(), pred);
+
+    // the joined pairs are recorded as offsets, with right.size() for no match
+    using pairs_t = std::vector<std::pair<size_t, size_t>>;
+    auto const expected_join = [&left, &right, &pred](cdmh::join_kind kind) {
+        pairs_t expected;
+        for (size_t loop=0; loop<left.size(); ++loop)
+        {
+            auto const matches = std::equal_range(right.begin(), right.end(), left[loop], pred);
+            if (matches.first == matches.second)
+            {
+                if (kind == cdmh::join_kind::left  ||  kind == cdmh::join_kind::anti)
+                    expected.push_back(std::make_pair(loop, right.size()));
+            }
+            else if (kind == cdmh::join_kind::semi)
+                expected.push_back(std::make_pair(loop, matches.first - right.begin()));
+            else if (kind != cdmh::join_kind::anti)
+            {
+                for (auto it=matches.first; it!=matches.second; ++it)
+                    expected.push_back(std::make_pair(loop, it - right.begin()));
+            }
+        }
+        return expected;
+    };
+
+    for (auto kind : { cdmh::join_kind::inner, cdmh::join_kind::left, cdmh::join_kind::semi, cdmh::join_kind::anti })
+    {
+        auto const expected = expected_join(kind);
+
+        pairs_t joined;
+        utils::counted(counters, left.size() + right.size(), [&]() {
+            cdmh::merge_join(left.cbegin(), left.cend(), right.cbegin(), right.cend(), kind, [&](iterator_t first, iterator_t second) {
+                joined.push_back(std::make_pair(first - left.cbegin(), second - right.cbegin()));
+            }, pred);
+        });
+        assert(joined == expected);
+
+        // the parts of a parallel join are joined at once, so the pairs are sorted to compare
+        std::mutex mutex;
+        joined.clear();
+        cdmh::parallel_merge_join(left.cbegin(), left.cend(), right.cbegin(), right.cend(), kind, [&](iterator_t first, iterator_t second) {
+            std::lock_guard<std::mutex> lock(mutex);
+            joined.push_back(std::make_pair(first - left.cbegin(), second - right.cbegin()));
+        }, pred, 3);
+        std::sort(joined.begin(), joined.end());
+        assert(joined == expected);
+    }
+
+    vector_t result, expected;
+    std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(expected), pred);
+    cdmh::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(result), pred);
+    assert(utils::matching_containers(result, expected));
+
+    result.clear();
+    expected.clear();
+    std::set_difference(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(expected), pred);
+    cdmh::set_difference(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(result), pred);
+    assert(utils::matching_containers(result, expected));
+
+    // lists are stepped through without galloping
+    std::list<typename C::value_type> left_list(left.begin(), left.end()), right_list(right.begin(), right.end());
+    result.clear();
+    cdmh::set_difference(left_list.begin(), left_list.end(), right_list.begin(), right_list.end(), std::back_inserter(result), pred);
+    assert(utils::matching_containers(result, expected));
+
+    // test the interface for default parameters
+    std::sort(left.begin(), left.end());
+    std::sort(right.begin(), right.end());
+    size_t count = 0;
+    cdmh::merge_join(left.cbegin(), left.cend(), right.cbegin(), right.cend(), cdmh::join_kind::inner, [&count](iterator_t, iterator_t) { ++count; });
+    cdmh::parallel_merge_join(left.cbegin(), left.cend(), right.cbegin(), right.cend(), cdmh::join_kind::semi, [](iterator_t, iterator_t) { });
+    cdmh::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(result));
+}
+
+// a join of a few keys with `size` rows, which gallops past the rows between the keys
+void merge_join_galloping(size_t size)
+{
+    using row = std::pair<int, int>;
+    struct key_less
+    {
+        bool operator()(row const &first, int second) const { ++*comparisons; return first.first < second; }
+        bool operator()(int first, row const &second) const { ++*comparisons; return first < second.first; }
+        std::atomic<size_t> *comparisons;
+    };
+
+    std::vector<row> rows;
+    for (size_t loop=0; loop<size; ++loop)
+        rows.push_back(row(int(loop / 3), int(loop)));
+    // the first and last keys are not in the table
+    std::vector<int> keys;
+    for (int key=-1; key<int(size / 3); key+=997)
+        keys.push_back(key);
+    keys.push_back(int(size));
+    size_t const matched = 3 * (keys.size() - 2);
+
+    std::atomic<size_t> comparisons(0);
+    key_less const pred = { &comparisons };
+    std::atomic<size_t> joined(0);
+    auto const count = [&joined](std::vector<row>::const_iterator, std::vector<int>::const_iterator) { ++joined; };
+    cdmh::merge_join(rows.cbegin(), rows.cend(), keys.cbegin(), keys.cend(), cdmh::join_kind::inner, count, pred);
+    assert(joined == matched);
+    std::clog << "Merge Join of " << keys.size() << " keys with " << size << " rows: " << comparisons << " comparisons\n";
+    assert(comparisons < size / 10);
+
+    joined = 0;
+    cdmh::parallel_merge_join(rows.cbegin(), rows.cend(), keys.cbegin(), keys.cend(), cdmh::join_kind::anti, count, pred, 4);
+    assert(joined == size - matched);
+
+    std::vector<row> result;
+    cdmh::set_intersection(rows.begin(), rows.end(), keys.begin(), keys.end(), std::back_inserter(result), pred);
+    assert(result.size() == keys.size() - 2  &&  result.back().first == keys[keys.size() - 2]);
+}
+
+template<typename C, typename Pred>
+void lazy_sorted_view(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    // the lazy sorted view requires random access iterators, so list is not tested here
+    std::clog << "Lazy Sorted View " << container.size() << " elements \n";
+    auto const expected = utils::sorted(container, pred);
+    for (size_t count : { 0, 1, 10, 40 })
+    {
+        // read a page of elements and then the rest, which leaves the range sorted
+        C values(container);
+        cdmh::lazy_sorted_view<typename C::iterator, Pred> view(values.begin(), values.end(), pred);
+        std::pair<typename C::iterator, typename C::iterator> page;
+        utils::counted(counters, values.size(), [&]() { page = view.prefix(count); });
+        assert(std::equal(page.first, page.second, expected.begin()));
+        assert(view.sorted() >= size_t(page.second - page.first));
+
+        std::clog << "--> ";
+        utils::dump(page.first, page.second);
+        std::clog << " ...\n";
+
+        auto it = expected.begin();
+        for (auto const &value : view)
+            assert(value == *it++);
+        assert(utils::matching_containers(values, expected));
+    }
+
+    std::deque<typename C::value_type> deque(container.begin(), container.end());
+    auto view = cdmh::make_lazy_sorted_view(deque.begin(), deque.end(), pred);
+    if (!deque.empty())
+        assert(view[deque.size() / 2] == expected[deque.size() / 2]);
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    auto default_view = cdmh::make_lazy_sorted_view(container.begin(), container.end());
+    default_view.prefix(5);
+}
+
+template<typename C, typename Pred>
+void merge_sort_copy(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Merge Sort (copy) " << container.size() << " elements\n";
     sort_container_copy(
@@ -228,19 +1023,33 @@ void merge_sort_copy(C container, Pred pred)
             typename std::vector<typename C::value_type>::iterator,
             std::back_insert_iterator<typename std::vector<typename C::value_type>>, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container_copy(
         cdmh::merge_sort_copy<
             typename std::list<typename C::value_type>::iterator,
             typename std::back_insert_iterator<typename std::list<typename C::value_type>>, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container_copy(
         cdmh::merge_sort_copy<
             typename std::deque<typename C::value_type>::iterator,
             typename std::back_insert_iterator<typename std::deque<typename C::value_type>>, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
+
+    // scratch memory from an arena, a buffer of the elements and half as many for merging
+    cdmh::arena arena;
+    sort_container_copy(
+        [&arena](typename std::list<typename C::value_type>::iterator begin, typename std::list<typename C::value_type>::iterator end, std::back_insert_iterator<std::list<typename C::value_type>> result, Pred pred) {
+            cdmh::merge_sort_copy(begin, end, result, pred, cdmh::arena_allocator<char>(arena));
+        },
+        std::list<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+    assert(arena.used() == (container.size() + container.size() / 2) * sizeof(typename C::value_type));
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
@@ -249,21 +1058,41 @@ void merge_sort_copy(C container, Pred pred)
 }
 
 template<typename C, typename Pred>
-void merge_sort(C container, Pred pred)
+void merge_sort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Merge Sort (inplace)" << container.size() << " elements\n";
     sort_container(
         cdmh::merge_sort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::merge_sort<typename std::list<typename C::value_type>::iterator, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::merge_sort<typename std::deque<typename C::value_type>::iterator, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
+
+    // merging through a scratch buffer from the calling thread's arena
+    sort_container(
+        [](typename std::vector<typename C::value_type>::iterator begin, typename std::vector<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::merge_sort(begin, end, pred, cdmh::arena_allocator<typename C::value_type>());
+        },
+        std::vector<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+    sort_container(
+        [](typename std::list<typename C::value_type>::iterator begin, typename std::list<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::merge_sort(begin, end, pred, std::allocator<typename C::value_type>());
+        },
+        std::list<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+    cdmh::thread_arena().release();
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
@@ -271,21 +1100,24 @@ void merge_sort(C container, Pred pred)
 }
 
 template<typename C, typename Pred>
-void minmax_sort(C container, Pred pred)
+void minmax_sort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog  << "MinMax sort " << container.size() << " elements \n";
     sort_container(
         cdmh::minmax_sort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::minmax_sort<typename std::list<typename C::value_type>::iterator, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::minmax_sort<typename std::deque<typename C::value_type>::iterator, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
@@ -293,48 +1125,896 @@ void minmax_sort(C container, Pred pred)
 }
 
 template<typename C, typename Pred>
-void quicksort(C container, Pred pred)
+void multiway_merge_sort(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    // the multiway merge sort requires random access iterators, so list is not tested here
+    std::clog << "Multiway Merge Sort " << container.size() << " elements\n";
+    sort_container(
+        [](typename std::vector<typename C::value_type>::iterator begin, typename std::vector<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::multiway_merge_sort(begin, end, pred);
+        },
+        std::vector<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+    sort_container(
+        [](typename std::deque<typename C::value_type>::iterator begin, typename std::deque<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::multiway_merge_sort(begin, end, pred);
+        },
+        std::deque<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+
+    // the elements are moved into the buffer, so need not be default constructible
+    struct indexed
+    {
+        indexed(typename C::value_type value, size_t index) : value(value), index(index) { }
+        typename C::value_type value;
+        size_t                 index;
+    };
+    auto const by_value = [&pred](indexed const &first, indexed const &second) { return pred(first.value, second.value); };
+    std::vector<indexed> values, expected;
+    for (auto const &value : container)
+        values.push_back(indexed(value, values.size()));
+    expected = values;
+    std::stable_sort(expected.begin(), expected.end(), by_value);
+    cdmh::multiway_merge_sort(values.begin(), values.end(), by_value);
+    assert(std::equal(values.begin(), values.end(), expected.begin(), [](indexed const &first, indexed const &second) {
+        return first.index == second.index;
+    }));
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::multiway_merge_sort(container.begin(), container.end());
+}
+
+// a multiway merge sort of `size` large elements, timed against merge_sort and
+// std::stable_sort
+void multiway_merge_sort_timed(size_t size)
+{
+    struct element
+    {
+        int  key;
+        int  index;
+        char padding[1016];
+    };
+    std::vector<element> container(size);
+    for (size_t loop=0; loop<size; ++loop)
+    {
+        container[loop].key   = std::rand() % 100;
+        container[loop].index = int(loop);
+    }
+    auto const less = [](element const &first, element const &second) { return first.key < second.key; };
+    std::vector<element> merged(container);
+    std::vector<element> stable(container);
+
+    auto const start = std::chrono::steady_clock::now();
+    cdmh::multiway_merge_sort(container.begin(), container.end(), less);
+    auto const multiway = std::chrono::steady_clock::now();
+    cdmh::merge_sort(merged.begin(), merged.end(), less);
+    auto const merge = std::chrono::steady_clock::now();
+    std::stable_sort(stable.begin(), stable.end(), less);
+    auto const finish = std::chrono::steady_clock::now();
+    for (size_t loop=0; loop<size; ++loop)
+        assert(container[loop].index == stable[loop].index  &&  merged[loop].index == stable[loop].index);
+
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    std::clog << "Multiway Merge Sort " << size << " elements of " << sizeof(element) << " bytes: "
+              << milliseconds(multiway - start).count() << "ms, against merge_sort "
+              << milliseconds(merge - multiway).count() << "ms and std::stable_sort "
+              << milliseconds(finish - merge).count() << "ms" << std::endl;
+}
+
+// keys encoded from values of each type compare as the values do, in either direction
+void normalized_key_encoding()
+{
+    auto const less = [](cdmh::key_encoder const &first, cdmh::key_encoder const &second) {
+        return cdmh::key_encoder::compare(first.data(), first.size(), second.data(), second.size()) < 0;
+    };
+    auto const key = [](std::function<void (cdmh::key_encoder &)> const &add) {
+        cdmh::key_encoder encoder;
+        add(encoder);
+        return encoder;
+    };
+    assert(less(key([](cdmh::key_encoder &e) { e.add(-1); }), key([](cdmh::key_encoder &e) { e.add(0); })));
+    assert(less(key([](cdmh::key_encoder &e) { e.add(0, cdmh::sort_order::descending); }), key([](cdmh::key_encoder &e) { e.add(-1, cdmh::sort_order::descending); })));
+    assert(less(key([](cdmh::key_encoder &e) { e.add(-2.5); }), key([](cdmh::key_encoder &e) { e.add(-0.0); })));
+    assert(key([](cdmh::key_encoder &e) { e.add(-0.0); }).str() == key([](cdmh::key_encoder &e) { e.add(0.0); }).str());
+    assert(less(key([](cdmh::key_encoder &e) { e.add(HUGE_VAL); }), key([](cdmh::key_encoder &e) { e.add(std::nan("")); })));
+    assert(less(key([](cdmh::key_encoder &e) { e.add(std::string("ab")); }), key([](cdmh::key_encoder &e) { e.add(std::string("ab\0", 3)); })));
+    assert(less(key([](cdmh::key_encoder &e) { e.add(std::string("ab\0", 3)); }), key([](cdmh::key_encoder &e) { e.add(std::string("abc")); })));
+    assert(less(key([](cdmh::key_encoder &e) { e.add("abc", cdmh::sort_order::descending); }), key([](cdmh::key_encoder &e) { e.add("ab", cdmh::sort_order::descending); })));
+    assert(less(key([](cdmh::key_encoder &e) { e.not_null().add(1); }), key([](cdmh::key_encoder &e) { e.null(cdmh::null_order::nulls_last); })));
+    assert(less(key([](cdmh::key_encoder &e) { e.null(); }), key([](cdmh::key_encoder &e) { e.not_null().add(1); })));
+}
+
+// `size` rows sorted by (tenant asc, time desc, name asc, score desc nulls last) with
+// normalised keys, and by their prefixes and a comparator, against std::stable_sort
+void normalized_key_sort(size_t size)
+{
+    struct row
+    {
+        int         tenant;
+        long long   time;
+        std::string name;
+        bool        scored;
+        double      score;
+        size_t      index;
+    };
+    std::vector<row> rows(size);
+    for (size_t loop=0; loop<size; ++loop)
+    {
+        row &r = rows[loop];
+        r.tenant = std::rand() % 5 - 2;
+        r.time   = std::rand() % 20 - 10;
+        r.name   = std::string(std::rand() % 12, char('a' + std::rand() % 3));
+        r.scored = std::rand() % 4 != 0;
+        r.score  = std::rand() % 5 - 2;
+        r.index  = loop;
+    }
+    auto const encode = [](row const &r, cdmh::key_encoder &encoder) {
+        encoder.add(r.tenant).add(r.time, cdmh::sort_order::descending).add(r.name);
+        if (r.scored)
+            encoder.not_null().add(r.score, cdmh::sort_order::descending);
+        else
+            encoder.null(cdmh::null_order::nulls_last);
+    };
+    auto const less = [](row const &first, row const &second) {
+        if (first.tenant != second.tenant)
+            return first.tenant < second.tenant;
+        else if (first.time != second.time)
+            return first.time > second.time;
+        else if (first.name != second.name)
+            return first.name < second.name;
+        else if (first.scored != second.scored)
+            return first.scored;
+        return first.scored  &&  first.score > second.score;
+    };
+
+    std::vector<row> expected(rows);
+    std::stable_sort(expected.begin(), expected.end(), less);
+    std::vector<row> prefixed(rows);
+    cdmh::sort_by_normalized_key(rows.begin(), rows.end(), encode);
+    cdmh::sort_by_key_prefix(prefixed.begin(), prefixed.end(), encode, less);
+    for (size_t loop=0; loop<size; ++loop)
+        assert(rows[loop].index == expected[loop].index  &&  prefixed[loop].index == expected[loop].index);
+    std::clog << "Normalized Key Sort " << size << " rows" << std::endl;
+}
+
+template<typename C, typename Pred>
+void nth_element(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    std::clog << "Nth Element " << container.size() << " elements \n";
+    for (auto nth : { size_t(0), container.size() / 3, container.size() / 2, container.size() - 1 })
+    {
+        if (nth >= container.size())
+            continue;
+        select_container(
+            cdmh::nth_element<typename std::vector<typename C::value_type>::iterator, Pred>,
+            std::vector<typename C::value_type>(container.begin(), container.end()),
+            nth,
+            pred,
+            counters);
+        select_container(
+            cdmh::nth_element<typename std::list<typename C::value_type>::iterator, Pred>,
+            std::list<typename C::value_type>(container.begin(), container.end()),
+            nth,
+            pred,
+            counters);
+        select_container(
+            cdmh::nth_element<typename std::deque<typename C::value_type>::iterator, Pred>,
+            std::deque<typename C::value_type>(container.begin(), container.end()),
+            nth,
+            pred,
+            counters);
+    }
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::nth_element(container.begin(), container.begin() + container.size() / 2, container.end());
+}
+
+template<typename C, typename Pred>
+void parallel_sort(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    // the parallel sort requires random access iterators, so list is not tested here
+    std::clog << "Parallel Sort " << container.size() << " elements \n";
+    sort_container(
+        [](typename std::vector<typename C::value_type>::iterator begin, typename std::vector<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::parallel_sort(begin, end, pred, 4);
+        },
+        std::vector<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+    sort_container(
+        [](typename std::deque<typename C::value_type>::iterator begin, typename std::deque<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::parallel_sort(begin, end, pred, 4);
+        },
+        std::deque<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::parallel_sort(container.begin(), container.end());
+}
+
+template<typename C, typename Pred>
+void partial_sort(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    std::clog << "Partial Sort " << container.size() << " elements \n";
+    for (auto k : { size_t(0), size_t(1), size_t(10), container.size() / 2, container.size() })
+    {
+        if (k > container.size())
+            continue;
+        partial_sort_container(
+            cdmh::partial_sort<typename std::vector<typename C::value_type>::iterator, Pred>,
+            std::vector<typename C::value_type>(container.begin(), container.end()),
+            k,
+            pred,
+            counters);
+        partial_sort_container(
+            cdmh::partial_sort<typename std::list<typename C::value_type>::iterator, Pred>,
+            std::list<typename C::value_type>(container.begin(), container.end()),
+            k,
+            pred,
+            counters);
+        partial_sort_container(
+            cdmh::partial_sort<typename std::deque<typename C::value_type>::iterator, Pred>,
+            std::deque<typename C::value_type>(container.begin(), container.end()),
+            k,
+            pred,
+            counters);
+    }
+
+    // top_k clamps k to the size of the data
+    std::vector<typename C::value_type> values(container.begin(), container.end());
+    auto const expected = utils::sorted(values, pred);
+    auto it = values.begin();
+    utils::counted(counters, values.size(), [&]() { it = cdmh::top_k(values.begin(), values.end(), 10, pred); });
+    assert(it - values.begin() == std::min<ptrdiff_t>(10, values.size()));
+    assert(std::equal(values.begin(), it, expected.begin(), [&pred](typename C::value_type const &a, typename C::value_type const &b) {
+        return !pred(a, b)  &&  !pred(b, a);
+    }));
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::partial_sort(container.begin(), container.begin() + container.size() / 2, container.end());
+    cdmh::top_k(container.begin(), container.end(), 3);
+}
+
+template<typename C, typename Pred>
+void quicksort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Quicksort " << container.size() << " elements \n";
     sort_container(
         cdmh::quicksort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::quicksort<typename std::list<typename C::value_type>::iterator, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::quicksort<typename std::deque<typename C::value_type>::iterator, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
 
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
     cdmh::quicksort(container.begin(), container.end());
 }
 
+#if defined(__unix__) || defined(__APPLE__)
+struct introsort_engine
+{
+    template<typename It, typename Pred>
+    void operator()(It begin, It end, Pred pred) const { cdmh::introsort(begin, end, pred); }
+};
+
+template<size_t Size>
+void record_sort(size_t count)
+{
+    std::clog << "Record Sort " << count << " records of " << Size << " bytes\n";
+
+    // records hold a big-endian key at offset 4 and their original position at offset 0
+    std::vector<cdmh::record<Size>> records(count);
+    for (size_t loop=0; loop<count; ++loop)
+    {
+        std::memset(records[loop].bytes, 0, Size);
+        std::memcpy(records[loop].bytes, &loop, 4);
+        records[loop].bytes[4] = std::rand() % 4;
+        records[loop].bytes[5] = std::rand() % 256;
+    }
+
+    char path[] = "/tmp/cdmh_record_sortXXXXXX";
+    int const fd = mkstemp(path);
+    assert(fd != -1);
+    for (size_t loop=0; loop<2; ++loop)
+    {
+        auto const written = write(fd, records.data(), count * Size);
+        assert(written == ssize_t(count * Size));
+        static_cast<void>(written);
+
+        // sort as record<Size> and then by index as records of a run time size
+        if (loop == 0)
+            cdmh::sort_mapped_file<Size>(path, 4, 2, cdmh::introsort<cdmh::record<Size> *, cdmh::record_key_less>);
+        else
+            cdmh::sort_mapped_file(path, Size, 4, 2, introsort_engine());
+
+        std::vector<cdmh::record<Size>> sorted(count);
+        auto const read = pread(fd, sorted.data(), count * Size, 0);
+        assert(read == ssize_t(count * Size));
+        static_cast<void>(read);
+        assert(std::is_sorted(sorted.begin(), sorted.end(), cdmh::record_key_less(4, 2)));
+
+        // every record is intact and present once
+        std::vector<bool> seen(count);
+        for (auto const &record : sorted)
+        {
+            size_t position = 0;
+            std::memcpy(&position, record.bytes, 4);
+            assert(position < count  &&  !seen[position]);
+            assert(std::memcmp(record.bytes, records[position].bytes, Size) == 0);
+            seen[position] = true;
+        }
+        lseek(fd, 0, SEEK_SET);
+    }
+    close(fd);
+    unlink(path);
+}
+
+void sort_sampler()
+{
+    std::clog << "Sort Sampler\n";
+    char path[] = "/tmp/cdmh_sort_samplerXXXXXX";
+    int const fd = mkstemp(path);
+    assert(fd != -1);
+    close(fd);
+
+    std::vector<int> ints(1000);
+    for (size_t loop=0; loop<ints.size(); ++loop)
+        ints[loop] = int(loop);
+    std::list<double> doubles(ints.rbegin(), ints.rend());
+    std::vector<std::string> strings(100000, "text");
+
+    // every call is sampled, but not the introsort of each part of the parallel sort
+    cdmh::sort_sampler::start(path, 1);
+    cdmh::introsort(ints.begin(), ints.end());
+    cdmh::merge_sort(doubles.begin(), doubles.end());
+    cdmh::parallel_sort(strings.begin(), strings.end(), std::less<std::string>(), 4);
+    cdmh::sort_sampler::stop();
+    cdmh::heap_sort(ints.begin(), ints.end());
+
+    std::vector<cdmh::sort_sample> samples;
+    bool const read = cdmh::sort_sampler::read(path, samples);
+    unlink(path);
+    assert(read);
+    assert(samples.size() == 3);
+
+    assert(samples[0].algorithm == cdmh::sort_sample::introsort);
+    assert(samples[0].size == 1000  &&  samples[0].runs == 1  &&  samples[0].inversions == 0  &&  samples[0].pairs == 32 * 31 / 2);
+    assert(samples[0].value == cdmh::sort_sample::signed_integer  &&  samples[0].value_size == sizeof(int));
+    assert(samples[0].category == cdmh::sort_sample::contiguous);
+
+    assert(samples[1].algorithm == cdmh::sort_sample::merge_sort);
+    assert(samples[1].runs == 1000  &&  samples[1].inversions == samples[1].pairs);
+    assert(samples[1].value == cdmh::sort_sample::floating_point  &&  samples[1].category == cdmh::sort_sample::bidirectional);
+
+    assert(samples[2].algorithm == cdmh::sort_sample::parallel_sort  &&  samples[2].size == strings.size());
+    assert(samples[2].value == cdmh::sort_sample::string  &&  samples[2].runs == 1);
+}
+
+void sort_trace()
+{
+    std::clog << "Sort Trace\n";
+    char path[] = "/tmp/cdmh_sort_traceXXXXXX";
+    int const fd = mkstemp(path);
+    assert(fd != -1);
+    close(fd);
+
+    std::vector<int> ints(100000);
+    for (size_t loop=0; loop<ints.size(); ++loop)
+        ints[loop] = int((loop * 7919) % ints.size());
+    std::vector<int> copy(ints);
+    std::vector<int> halves(ints.begin(), ints.begin() + 10000);
+
+    // spans are recorded for subranges of 1000 elements or more, and not after stop()
+    cdmh::sort_trace::start(1000);
+    cdmh::introsort(ints.begin(), ints.end());
+    cdmh::merge_sort(halves.begin(), halves.end());
+    cdmh::heap_sort(copy.begin(), copy.begin() + 5000);
+    cdmh::parallel_sort(copy.begin(), copy.end(), std::less<int>(), 4);
+    cdmh::sort_trace::stop();
+    cdmh::quicksort(ints.begin(), ints.end(), std::greater<int>());
+
+    auto const events = cdmh::sort_trace::events();
+    auto const count = [&events](char const *name) {
+        return std::count_if(events.begin(), events.end(), [name](cdmh::trace_event const &event) {
+            return std::strcmp(event.name, name) == 0;
+        });
+    };
+    assert(count("quicksort") == 0  &&  count("heap_sort") == 1  &&  count("parallel_sort") == 1  &&  count("kway_merge") == 4);
+    assert(count("merge") == count("merge_sort")  &&  count("merge") == 15);
+    assert(std::all_of(events.begin(), events.end(), [](cdmh::trace_event const &event) {
+        return event.size >= 1000  &&  event.start <= event.end;
+    }));
+
+    // every span but the outermost on its thread is inside a span one level up
+    for (auto const &event : events)
+    {
+        if (event.depth == 0)
+            continue;
+        assert(std::any_of(events.begin(), events.end(), [&event](cdmh::trace_event const &parent) {
+            return parent.thread == event.thread  &&  parent.depth + 1 == event.depth
+               &&  parent.start <= event.start  &&  event.end <= parent.end  &&  event.size <= parent.size;
+        }));
+    }
+
+    // the first span is the introsort of the whole range, which starts by partitioning it
+    assert(std::strcmp(events[0].name, "introsort") == 0  &&  events[0].size == ints.size()  &&  events[0].depth == 0);
+    assert(std::strcmp(events[1].name, "partition") == 0  &&  events[1].size == ints.size()  &&  events[1].depth == 1);
+    assert(events[1].phase == cdmh::trace_event::partition);
+
+    // the parts of a parallel sort are sorted and merged on threads of their own
+    std::vector<std::uint32_t> threads;
+    for (auto const &event : events)
+    {
+        if (std::strcmp(event.name, "kway_merge") == 0)
+            threads.push_back(event.thread);
+    }
+    std::sort(threads.begin(), threads.end());
+    assert(std::unique(threads.begin(), threads.end()) == threads.end());
+
+    bool const written = cdmh::sort_trace::write(path);
+    assert(written);
+    std::string json;
+    if (std::FILE *file = std::fopen(path, "r"))
+    {
+        char buffer[4096];
+        for (size_t read; (read = std::fread(buffer, 1, sizeof(buffer), file)) != 0; )
+            json.append(buffer, read);
+        std::fclose(file);
+    }
+    unlink(path);
+
+    size_t spans = 0;
+    for (size_t at=0; (at = json.find("\"ph\":\"X\"", at)) != std::string::npos; ++at)
+        ++spans;
+    assert(json.compare(0, 16, "{\"traceEvents\":[") == 0  &&  spans == events.size());
+    assert(json.find("{\"name\":\"partition\",\"cat\":\"partition\",\"ph\":\"X\",\"ts\":") != std::string::npos);
+    assert(json.find("\"args\":{\"depth\":0,\"size\":100000}}") != std::string::npos);
+
+    // restarting discards the events recorded before
+    cdmh::sort_trace::start();
+    cdmh::sort_trace::stop();
+    assert(cdmh::sort_trace::events().empty());
+}
+
+#endif
+
+// a sorted range with a few, then many, elements modified, sorted again in place
+// and by merging. modified elements come after the unmodified elements equivalent to
+// them, and modified elements equivalent to each other are in the order of their
+// indices, which is a stable sort of the unmodified elements followed by the modified
+void resort_dirty(size_t size)
+{
+    std::clog << "Resort Dirty " << size << " elements \n";
+    for (size_t modified : { 0, 1, 5, 8, 9, 100, 2000 })
+    {
+        // each element holds its index in the sorted range
+        std::vector<std::pair<int, size_t>> container(size);
+        for (size_t loop=0; loop<container.size(); ++loop)
+            container[loop].first = std::rand() % 1000;
+        auto const greater = [](std::pair<int, size_t> const &first, std::pair<int, size_t> const &second) {
+            return first.first > second.first;
+        };
+        std::stable_sort(container.begin(), container.end(), greater);
+        for (size_t loop=0; loop<container.size(); ++loop)
+            container[loop].second = loop;
+
+        std::vector<size_t> dirty;
+        std::vector<bool> is_dirty(container.size());
+        for (size_t loop=0; loop<modified; ++loop)
+        {
+            dirty.push_back(std::rand() % container.size());
+            container[dirty.back()].first = std::rand() % 1000;
+            is_dirty[dirty.back()] = true;
+        }
+
+        std::vector<std::pair<int, size_t>> expected;
+        for (bool const modified_elements : { false, true })
+        {
+            for (size_t loop=0; loop<container.size(); ++loop)
+            {
+                if (is_dirty[loop] == modified_elements)
+                    expected.push_back(container[loop]);
+            }
+        }
+        std::stable_sort(expected.begin(), expected.end(), greater);
+        cdmh::resort_dirty(container.begin(), container.end(), dirty, greater);
+        assert(container == expected);
+    }
+}
+
 template<typename C, typename Pred>
-void selection_sort(C container, Pred pred)
+void segmented_sort(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    // the segmented sort requires random access iterators, so list is not tested here
+    std::clog << "Segmented Sort " << container.size() << " elements \n";
+
+    // a skewed set of segments: one of half the elements, then segments of increasing size
+    std::vector<size_t> offsets(1, 0);
+    offsets.push_back(container.size() / 2);
+    while (offsets.back() + offsets.size() < container.size())
+        offsets.push_back(offsets.back() + offsets.size() - 2);
+    offsets.push_back(container.size());
+
+    // odd numbered segments are sorted in the reverse order
+    auto const pred_for = [&pred](size_t segment) {
+        return [segment, pred](typename C::value_type const &first, typename C::value_type const &second) {
+            return (segment % 2)? pred(second, first) : pred(first, second);
+        };
+    };
+
+    for (unsigned threads : { 1, 3 })
+    {
+        std::vector<typename C::value_type> values(container.begin(), container.end());
+        utils::counted(counters, values.size(), [&]() { cdmh::segmented_sort_by(values.begin(), offsets.begin(), offsets.end(), pred_for, threads); });
+        for (size_t segment=0; segment+1<offsets.size(); ++segment)
+        {
+            std::vector<typename C::value_type> expected(container.begin() + offsets[segment], container.begin() + offsets[segment + 1]);
+            std::sort(expected.begin(), expected.end(), pred_for(segment));
+            assert(std::equal(expected.begin(), expected.end(), values.begin() + offsets[segment]));
+        }
+
+        values.assign(container.begin(), container.end());
+        utils::counted(counters, values.size(), [&]() { cdmh::segmented_sort(values.begin(), offsets.begin(), offsets.end(), pred, threads); });
+        for (size_t segment=0; segment+1<offsets.size(); ++segment)
+            assert(std::is_sorted(values.begin() + offsets[segment], values.begin() + offsets[segment + 1], pred));
+
+        std::clog << "--> ";
+        utils::dump(values.begin(), values.end());
+        std::clog << '\n';
+    }
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::segmented_sort(container.begin(), offsets.begin(), offsets.end());
+}
+
+template<typename C, typename Pred>
+void selection_sort(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Selection sort " << container.size() << " elements \n";
     sort_container(
         cdmh::selection_sort<typename std::vector<typename C::value_type>::iterator, Pred>,
         std::vector<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::selection_sort<typename std::list<typename C::value_type>::iterator, Pred>,
         std::list<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     sort_container(
         cdmh::selection_sort<typename std::deque<typename C::value_type>::iterator, Pred>,
         std::deque<typename C::value_type>(container.begin(), container.end()),
-        pred);
+        pred,
+        counters);
     // test the interface for default parameters
     std::random_shuffle(container.begin(), container.end());
     cdmh::selection_sort(container.begin(), container.end());
 }
 
+template<typename C, typename Pred>
+void sort_task(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    // the sort task requires random access iterators, so list is not tested here
+    std::clog << "Sort Task " << container.size() << " elements \n";
+    for (size_t budget : { 1, 7, 1000 })
+    {
+        sort_container(
+            [budget](typename std::vector<typename C::value_type>::iterator begin, typename std::vector<typename C::value_type>::iterator end, Pred pred) {
+                auto task = cdmh::make_sort_task(begin, end, pred);
+                while (!task.resume(budget))
+                    assert(!task.done());
+            },
+            std::vector<typename C::value_type>(container.begin(), container.end()),
+            pred,
+            counters);
+    }
+    sort_container(
+        [](typename std::deque<typename C::value_type>::iterator begin, typename std::deque<typename C::value_type>::iterator end, Pred pred) {
+            cdmh::sort_task<typename std::deque<typename C::value_type>::iterator, Pred> task(begin, end, pred);
+            while (!task.resume_for(std::chrono::microseconds(10)))
+                ;
+        },
+        std::deque<typename C::value_type>(container.begin(), container.end()),
+        pred,
+        counters);
+
+    // a cancelled task stops, leaving a permutation of the elements
+    C values(container);
+    auto task = cdmh::make_sort_task(values.begin(), values.end(), pred);
+    task.resume(5);
+    task.cancel();
+    assert(task.done()  &&  task.cancelled()  &&  task.resume(5));
+    assert(std::is_permutation(values.begin(), values.end(), container.begin()));
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::make_sort_task(container.begin(), container.end()).run();
+}
+
+// time a sort task resumed for a millisecond at a time against a blocking introsort
+void sort_task_timed(std::vector<int> container)
+{
+    for (auto &value : container)
+        value = std::rand();
+    std::vector<int> blocking(container);
+
+    auto const start = std::chrono::steady_clock::now();
+    cdmh::introsort(blocking.begin(), blocking.end());
+    auto const middle = std::chrono::steady_clock::now();
+    auto task = cdmh::make_sort_task(container.begin(), container.end());
+    size_t slices = 1;
+    while (!task.resume_for(std::chrono::milliseconds(1)))
+        ++slices;
+    auto const finish = std::chrono::steady_clock::now();
+    assert(container == blocking);
+
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    std::clog << "Sort Task " << container.size() << " elements in " << slices << " slices: "
+              << milliseconds(finish - middle).count() << "ms, against introsort "
+              << milliseconds(middle - start).count() << "ms" << std::endl;
+}
+
+template<typename Unique, typename C, typename Pred>
+void sort_unique_container(Unique unique, C container, Pred pred)
+{
+    using value_type = typename C::value_type;
+    C expected(utils::sorted(container, pred));
+    expected.erase(
+        std::unique(expected.begin(), expected.end(), [&pred](value_type const &a, value_type const &b) {
+            return !pred(a, b)  &&  !pred(b, a);
+        }),
+        expected.end());
+
+    container.erase(unique(container.begin(), container.end(), pred), container.end());
+
+    std::clog << "--> ";
+    utils::dump(container.begin(), container.end());
+    std::clog << '\n';
+
+    assert(std::equal(container.begin(), container.end(), expected.begin(), [&pred](value_type const &a, value_type const &b) {
+        return !pred(a, b)  &&  !pred(b, a);
+    }));
+    assert(container.size() == expected.size());
+}
+
+template<typename C, typename Pred>
+void sort_unique(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    using value_type = typename C::value_type;
+    std::clog << "Sort Unique " << container.size() << " elements \n";
+    sort_unique_container(
+        cdmh::sort_unique<typename std::vector<value_type>::iterator, Pred>,
+        std::vector<value_type>(container.begin(), container.end()),
+        pred);
+    sort_unique_container(
+        cdmh::sort_unique<typename std::list<value_type>::iterator, Pred>,
+        std::list<value_type>(container.begin(), container.end()),
+        pred);
+    sort_unique_container(
+        cdmh::sort_unique<typename std::deque<value_type>::iterator, Pred>,
+        std::deque<value_type>(container.begin(), container.end()),
+        pred);
+
+    // count the occurrences of each element by reducing pairs of an element and a count
+    using counted = std::pair<value_type, size_t>;
+    std::vector<counted> counts;
+    for (auto const &value : container)
+        counts.push_back(counted(value, 1));
+    auto const counted_pred = [&pred](counted const &a, counted const &b) { return pred(a.first, b.first); };
+    auto const add_counts   = [](counted &into, counted &&from) { into.second += from.second; };
+    utils::counted(counters, counts.size(), [&]() {
+        counts.erase(cdmh::sort_reduce_by_key(counts.begin(), counts.end(), counted_pred, add_counts), counts.end());
+    });
+    assert(std::is_sorted(counts.begin(), counts.end(), counted_pred));
+    size_t total = 0;
+    for (auto const &count : counts)
+    {
+        assert(count.second == size_t(std::count_if(container.begin(), container.end(), [&](value_type const &value) {
+            return !pred(value, count.first)  &&  !pred(count.first, value);
+        })));
+        total += count.second;
+    }
+    assert(total == container.size());
+
+    // collapse the two halves of the container separately, then merge them
+    auto const middle = cdmh::detail::advance(container.begin(), container.size() / 2);
+    std::vector<counted> first, second, merged;
+    for (auto it=container.begin(); it!=container.end(); ++it)
+        (it < middle? first : second).push_back(counted(*it, 1));
+    first.erase(cdmh::sort_reduce_by_key(first.begin(), first.end(), counted_pred, add_counts), first.end());
+    second.erase(cdmh::sort_reduce_by_key(second.begin(), second.end(), counted_pred, add_counts), second.end());
+    cdmh::merge_reduce_by_key(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(merged), counted_pred, add_counts);
+    assert(merged.size() == counts.size());
+    assert(std::equal(merged.begin(), merged.end(), counts.begin(), [&pred](counted const &a, counted const &b) {
+        return !pred(a.first, b.first)  &&  !pred(b.first, a.first)  &&  a.second == b.second;
+    }));
+
+    std::vector<value_type> lower(container.begin(), middle), upper(middle, container.end()), unique;
+    lower.erase(cdmh::sort_unique(lower.begin(), lower.end(), pred), lower.end());
+    upper.erase(cdmh::sort_unique(upper.begin(), upper.end(), pred), upper.end());
+    cdmh::merge_unique(lower.begin(), lower.end(), upper.begin(), upper.end(), std::back_inserter(unique), pred);
+    assert(unique.size() == counts.size());
+
+    // test the interface for default parameters
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::sort_unique(container.begin(), container.end());
+}
+
+template<typename C, typename Pred>
+void sorted_buffer(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    using value_type = typename C::value_type;
+    std::clog << "Sorted Buffer " << container.size() << " elements \n";
+    C expected(utils::sorted(container, pred));
+
+    // a small tail so the elements pass through several tiers of runs
+    cdmh::sorted_buffer<value_type, Pred> buffer(pred, 3);
+    for (auto it=container.begin(); it!=container.end(); ++it)
+    {
+        buffer.insert(*it);
+        assert(buffer.contains(*it));
+        assert(buffer.size() == size_t(std::distance(container.begin(), it)) + 1);
+    }
+
+    std::clog << "--> ";
+    utils::dump(buffer.begin(), buffer.end());
+    std::clog << '\n';
+
+    assert(buffer.runs() <= 1);
+    assert(std::equal(buffer.begin(), buffer.end(), expected.begin(), [&pred](value_type const &a, value_type const &b) {
+        return !pred(a, b)  &&  !pred(b, a);
+    }));
+
+    // a second burst of inserts merged into the single run
+    utils::counted(counters, container.size(), [&]() { buffer.insert(container.begin(), container.end()); });
+    assert(buffer.size() == 2 * container.size());
+    assert(std::is_sorted(buffer.begin(), buffer.end(), pred));
+    for (auto const &value : container)
+    {
+        assert(std::distance(buffer.lower_bound(value), buffer.upper_bound(value)) >= 2);
+        assert(!pred(buffer[buffer.lower_bound(value) - buffer.begin()], value));
+    }
+
+    // test the interface for default parameters
+    cdmh::sorted_buffer<value_type> defaults;
+    defaults.insert(container.begin(), container.end());
+    assert(std::is_sorted(defaults.begin(), defaults.end()));
+}
+
+template<typename C, typename Pred>
+void topk_accumulator(C container, Pred pred, cdmh::perf_counters *counters)
+{
+    std::clog << "Top-k Accumulator " << container.size() << " elements \n";
+    auto const expected = utils::sorted(std::vector<typename C::value_type>(container.begin(), container.end()), pred);
+    auto const equivalent = [&pred](typename C::value_type const &a, typename C::value_type const &b) {
+        return !pred(a, b)  &&  !pred(b, a);
+    };
+
+    for (size_t k : { 0, 1, 3, 10, 1000 })
+    {
+        // push one at a time, and in two halves to accumulators that are then merged
+        cdmh::topk_accumulator<typename C::value_type, Pred> accumulator(k, pred), first(k, pred), second(k, pred);
+        utils::counted(counters, container.size(), [&]() {
+            for (auto const &value : container)
+                accumulator.push(value);
+        });
+        auto const middle = cdmh::detail::advance(container.begin(), container.size() / 2);
+        first.push(container.begin(), middle);
+        second.push(middle, container.end());
+        first.merge(second);
+
+        auto const size = std::min(k, container.size());
+        assert(accumulator.size() == size);
+        for (auto *acc : { &accumulator, &first })
+        {
+            auto const result = acc->extract_sorted();
+            std::clog << "--> ";
+            utils::dump(result.begin(), result.end());
+            std::clog << '\n';
+            assert(result.size() == size);
+            assert(std::equal(result.begin(), result.end(), expected.begin(), equivalent));
+            assert(acc->size() == 0);
+        }
+    }
+
+    // an accumulator merged with itself holds each of its elements twice
+    std::vector<typename C::value_type> doubled(container.begin(), container.end());
+    doubled.insert(doubled.end(), container.begin(), container.end());
+    auto const doubled_expected = utils::sorted(doubled, pred);
+    cdmh::topk_accumulator<typename C::value_type, Pred> self(10, pred);
+    self.push(container.begin(), container.end());
+    self.merge(self);
+    auto const merged = self.extract_sorted();
+    assert(merged.size() == std::min<size_t>(10, doubled.size()));
+    assert(std::equal(merged.begin(), merged.end(), doubled_expected.begin(), equivalent));
+
+    // test the interface for default parameters
+    cdmh::topk_accumulator<typename C::value_type> accumulator(5);
+    accumulator.push(container.begin(), container.end());
+    accumulator.extract_sorted();
+}
+
+// the parallel sorts with enough data to be divided between threads
+void parallel_sorts(std::vector<int> container, cdmh::perf_counters *counters)
+{
+    for (size_t loop=0; loop<container.size(); ++loop)
+        container[loop] = loop % 1000;
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::test::algorithms::parallel_sort(container, std::less<int>(), counters);
+    cdmh::test::algorithms::parallel_sort(container, std::greater<int>(), counters);
+    cdmh::test::algorithms::segmented_sort(container, std::less<int>(), counters);
+    cdmh::test::algorithms::deque_sort(container, std::greater<int>(), counters);
+
+    // the buffer, and the lists of runs and trees of the merge, come from the caller's
+    // storage
+    std::vector<char> storage(1 << 20);
+    cdmh::arena arena(storage.data(), storage.size());
+    cdmh::parallel_sort(container.begin(), container.end(), std::less<int>(), 4, cdmh::arena_allocator<int>(arena));
+    assert(std::is_sorted(container.begin(), container.end()));
+    assert(arena.used() > container.size() * sizeof(int));
+    assert(arena.used() <= storage.size());
+
+    // the buffer is move constructed, so the elements need not be default constructible
+    struct without_default
+    {
+        explicit without_default(int value) : value(value)
+        {
+        }
+
+        int value;
+    };
+    std::vector<without_default> members;
+    for (auto const value : container)
+        members.push_back(without_default(value));
+    std::random_shuffle(members.begin(), members.end());
+    auto const by_member = [](without_default const &first, without_default const &second) {
+        return first.value < second.value;
+    };
+    cdmh::parallel_sort(members.begin(), members.end(), by_member, 4);
+    assert(std::is_sorted(members.begin(), members.end(), by_member));
+
+    // nothing is allocated on the threads the sorts start
+    std::atomic<size_t> foreign(0);
+    utils::calling_thread_allocator<int> const alloc(foreign);
+    std::random_shuffle(container.begin(), container.end());
+    cdmh::parallel_sort(container.begin(), container.end(), std::less<int>(), 4, alloc);
+    assert(std::is_sorted(container.begin(), container.end()));
+
+    std::vector<std::pair<int const *, int const *>> runs;
+    for (size_t run=0; run<4; ++run)
+        runs.push_back(std::make_pair(container.data() + container.size() * run / 4, container.data() + container.size() * (run + 1) / 4));
+    std::vector<int> merged(container.size());
+    cdmh::parallel_kway_merge(runs.begin(), runs.end(), merged.begin(), std::less<int>(), 4, alloc);
+    assert(std::is_sorted(merged.begin(), merged.end()));
+
+    std::vector<size_t> offsets = {0, container.size() / 2, container.size()};
+    cdmh::segmented_sort(container.begin(), offsets.begin(), offsets.end(), std::greater<int>(), 4, alloc);
+    assert(std::is_sorted(container.begin(), container.begin() + offsets[1], std::greater<int>()));
+
+    std::deque<int> deque(container.begin(), container.end());
+    cdmh::deque_sort(deque.begin(), deque.end(), std::less<int>(), 4, alloc);
+    assert(std::is_sorted(deque.begin(), deque.end()));
+    assert(foreign == 0);
+}
+
 }   // namespace algorithms
 
 namespace drivers {
@@ -415,65 +2095,85 @@ void partially_shuffled_ints(size_t size, Fn fn)
 }
 
 template<typename C, typename Pred>
-void test_sorts(C container, Pred pred)
+void test_sorts(C container, Pred pred, cdmh::perf_counters *counters)
 {
     // std::sort requires random access iterators, so list & deque are not supported
     std::clog << "std::sort " << container.size() << " elements\n";
-    [&pred](std::vector<typename C::value_type> container) {
+    [&pred, counters](std::vector<typename C::value_type> container) {
         wrappers::sort_between_iterators(
             container.begin(),
             container.end(),
             std::sort<
                 typename std::vector<typename C::value_type>::iterator,
                 decltype(pred)>,
-            pred);
+            pred,
+            counters);
     }(std::vector<typename C::value_type>(container.begin(), container.end()));
 
     // std::stable_sort requires random access iterators, so list & deque are not supported
     std::clog << "std::stable_sort " << container.size() << " elements\n";
-    [&pred](std::vector<typename C::value_type> container) {
+    [&pred, counters](std::vector<typename C::value_type> container) {
         wrappers::sort_between_iterators(
             container.begin(),
             container.end(),
             std::stable_sort<
                 typename std::vector<typename C::value_type>::iterator,
                 decltype(pred)>,
-            pred);
+            pred,
+            counters);
     }(std::vector<typename C::value_type>(container.begin(), container.end()));
 
-    algorithms::bubble_sort(container, pred);
-    algorithms::cocktail_sort(container, pred);
-    algorithms::heap_sort(container, pred);
-    algorithms::insertion_sort(container, pred);
-    algorithms::introsort_sort(container, pred);
-    algorithms::merge_sort(container, pred);
-    algorithms::merge_sort_copy(container, pred);
-    algorithms::minmax_sort(container, pred);
-    algorithms::quicksort(container, pred);
-    algorithms::selection_sort(container, pred);
+    algorithms::batch_sort(container, pred, counters);
+    algorithms::block_merge_sort(container, pred, counters);
+    algorithms::bubble_sort(container, pred, counters);
+    algorithms::cocktail_sort(container, pred, counters);
+    algorithms::deque_sort(container, pred, counters);
+    algorithms::heap_sort(container, pred, counters);
+    algorithms::insertion_sort(container, pred, counters);
+    algorithms::introsort_sort(container, pred, counters);
+    algorithms::kway_merge(container, pred, counters);
+    algorithms::lazy_sorted_view(container, pred, counters);
+    algorithms::merge_join(container, pred, counters);
+    algorithms::merge_sort(container, pred, counters);
+    algorithms::merge_sort_copy(container, pred, counters);
+    algorithms::minmax_sort(container, pred, counters);
+    algorithms::multiway_merge_sort(container, pred, counters);
+    algorithms::nth_element(container, pred, counters);
+    algorithms::parallel_sort(container, pred, counters);
+    algorithms::partial_sort(container, pred, counters);
+    algorithms::quicksort(container, pred, counters);
+    algorithms::segmented_sort(container, pred, counters);
+    algorithms::selection_sort(container, pred, counters);
+    algorithms::sort_task(container, pred, counters);
+    algorithms::sort_unique(container, pred, counters);
+    algorithms::sorted_buffer(container, pred, counters);
+    algorithms::topk_accumulator(container, pred, counters);
 }
 
 }   // namespace detail
 
 template<typename C, typename Pred>
-void test_stable_sorts(C container, Pred pred)
+void test_stable_sorts(C container, Pred pred, cdmh::perf_counters *counters)
 {
     std::clog << "Testing stability\n=================\n";
-    algorithms::bubble_sort(container, pred);
-    algorithms::cocktail_sort(container, pred);
-    algorithms::insertion_sort(container, pred);
-    algorithms::merge_sort(container, pred);
-    algorithms::merge_sort_copy(container, pred);
+    algorithms::block_merge_sort(container, pred, counters);
+    algorithms::bubble_sort(container, pred, counters);
+    algorithms::cocktail_sort(container, pred, counters);
+    algorithms::insertion_sort(container, pred, counters);
+    algorithms::kway_merge(container, pred, counters);
+    algorithms::merge_sort(container, pred, counters);
+    algorithms::merge_sort_copy(container, pred, counters);
+    algorithms::multiway_merge_sort(container, pred, counters);
 }
 
 template<typename C>
-void test_ascending_descending(C container)
+void test_ascending_descending(C container, cdmh::perf_counters *counters)
 {
     // test sort ascending
-    detail::test_sorts(container, std::less<typename C::value_type>());
+    detail::test_sorts(container, std::less<typename C::value_type>(), counters);
 
     // test sort descending
-    detail::test_sorts(container, std::greater<typename C::value_type>());
+    detail::test_sorts(container, std::greater<typename C::value_type>(), counters);
 }
 
 template<typename Fn>
@@ -486,7 +2186,7 @@ void sized_test(int const size, Fn fn)
     detail::partially_shuffled_ints(size, fn);
 }
 
-void run_exhaustive_tests(void)
+void run_exhaustive_tests(cdmh::perf_counters *counters)
 {
     // run exhaustive tests on arrays of these sizes
     std::vector<int> sizes { 0, 1, 5, 30, 31, 32, 33, 128, 1023, 1024 };
@@ -499,7 +2199,8 @@ void run_exhaustive_tests(void)
                     std::vector<int>,
                     std::less<int>>,
                 std::placeholders::_1,
-                std::less<int>()));
+                std::less<int>(),
+                counters));
 
         sized_test(
             size,
@@ -508,7 +2209,8 @@ void run_exhaustive_tests(void)
                     std::vector<int>,
                     std::greater<int>>,
                 std::placeholders::_1,
-                std::greater<int>()));
+                std::greater<int>(),
+                counters));
     }
 }
 
@@ -517,27 +2219,44 @@ void run_exhaustive_tests(void)
 }   // namespace test
 }   // namespace cdmh
 
-int main()
+int main(int argc, char *argv[])
 {
     using cdmh::test::drivers::run_exhaustive_tests;
     using cdmh::test::drivers::test_stable_sorts;
     using cdmh::test::drivers::test_ascending_descending;
 
-    test_ascending_descending(std::vector<int>{ 1, 2, 3, 4, 51, 2, 5, 6, 1, 6, 13, 1, 2, 3, 4, 5, 6, 14, 1, 2, 3, 4, 5, 6, 1 });
-    test_ascending_descending(std::vector<std::string>{ "the", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog" });
-    test_ascending_descending(std::vector<std::string>{ "the", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog" });
-    test_ascending_descending(std::vector<int>{});
-    test_ascending_descending(std::vector<int>{ 3 });
-    test_ascending_descending(std::vector<int>{ 3, 4, 5, 9, 8, 2, 1, 7, 6 });
-    test_ascending_descending(std::vector<int>{ 60, 10, 410, 40, 50, 60, 10, 40, 30, 40, 50, 60, 10, 40, 50, 6 });
-    test_ascending_descending(std::vector<int>{ 10, 20, 30, 40, 510, 20, 50, 60, 10, 60, 130, 10, 20, 30, 40, 50, 60, 140, 10, 20, 30, 40, 50, 60, 1 });
+    // --counters reports hardware performance counters for each sort, where available
+    std::unique_ptr<cdmh::perf_counters> hardware;
+    if (argc > 1  &&  std::strcmp(argv[1], "--counters") == 0)
+    {
+        hardware.reset(new cdmh::perf_counters);
+        if (!hardware->available())
+        {
+            std::clog << "Hardware performance counters are not available\n";
+            hardware.reset();
+        }
+    }
+    cdmh::perf_counters *const counters = hardware.get();
+
+    test_ascending_descending(std::vector<int>{ 1, 2, 3, 4, 51, 2, 5, 6, 1, 6, 13, 1, 2, 3, 4, 5, 6, 14, 1, 2, 3, 4, 5, 6, 1 }, counters);
+    test_ascending_descending(std::vector<std::string>{ "the", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog" }, counters);
+    test_ascending_descending(std::vector<std::string>{ "the", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog" }, counters);
+    test_ascending_descending(std::vector<int>{}, counters);
+    test_ascending_descending(std::vector<int>{ 3 }, counters);
+    test_ascending_descending(std::vector<int>{ 3, 4, 5, 9, 8, 2, 1, 7, 6 }, counters);
+    test_ascending_descending(std::vector<int>{ 60, 10, 410, 40, 50, 60, 10, 40, 30, 40, 50, 60, 10, 40, 50, 6 }, counters);
+    test_ascending_descending(std::vector<int>{ 10, 20, 30, 40, 510, 20, 50, 60, 10, 60, 130, 10, 20, 30, 40, 50, 60, 140, 10, 20, 30, 40, 50, 60, 1 }, counters);
 
     // test stability of a sort algorithm by comparing doubles as ints
     test_stable_sorts(
         std::vector<double>{ 1.2, 1.1, 0.4, 0.1, 0.9, 3.1, 3.6, 9.4, 9.8, 9.6, 3.2 },
         [](double const &first, double const &second) {
             return int(first)<int(second);
-        });
+        },
+        counters);
+
+    // and with many elements of few distinct keys, which exercise the block moves
+    cdmh::test::algorithms::block_merge_sort_stability(3000);
 
     // text sorts with enough data to exceed limits in the hybrid sorts
     test_ascending_descending(std::vector<char const *>{
@@ -553,7 +2272,7 @@ int main()
         "Maecenas", "nec", "ultricies", "ante", "quis", "congue", "tellus", "Vivamus", "cursus", "nisl", "ac", "nibh",
         "tempus", "eu", "iaculis", "nibh", "molestie", "Etiam", "tempus", "dolor", "nec", "consectetur", "tempor",
         "orci", "purus", "malesuada", "augue", "ut", "pharetra", "leo", "metus", "sed", "urna", "In", "suscipit",
-        "placerat", "velit", "nec", "eleifend", "Maecenas", "quis", "condimentum", "mi", "nec", "blandit", "justo"});
+        "placerat", "velit", "nec", "eleifend", "Maecenas", "quis", "condimentum", "mi", "nec", "blandit", "justo"}, counters);
 
     test_ascending_descending(std::vector<std::string>{
         "Lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "Praesent", "a", "posuere",
@@ -568,9 +2287,57 @@ int main()
         "Maecenas", "nec", "ultricies", "ante", "quis", "congue", "tellus", "Vivamus", "cursus", "nisl", "ac", "nibh",
         "tempus", "eu", "iaculis", "nibh", "molestie", "Etiam", "tempus", "dolor", "nec", "consectetur", "tempor",
         "orci", "purus", "malesuada", "augue", "ut", "pharetra", "leo", "metus", "sed", "urna", "In", "suscipit",
-        "placerat", "velit", "nec", "eleifend", "Maecenas", "quis", "condimentum", "mi", "nec", "blandit", "justo"});
+        "placerat", "velit", "nec", "eleifend", "Maecenas", "quis", "condimentum", "mi", "nec", "blandit", "justo"}, counters);
+
+    // segments of every size sorted by a network, of integers and of strings
+    cdmh::test::algorithms::batch_sort_networks<int>([](int value) { return value; });
+    cdmh::test::algorithms::batch_sort_networks<std::string>([](int value) { return std::to_string(value); });
+
+    // many small segments sorted by networks, against sorting each segment in turn
+    cdmh::test::algorithms::batch_sort_timed(100000);
+
+    // parallel sort with enough data to be divided between threads
+    cdmh::test::algorithms::parallel_sorts(std::vector<int>(100000), counters);
+
+    // join a few keys with a large table of rows sorted on their key; the galloping
+    // search skips the rows between the keys in far fewer comparisons than a merge
+    cdmh::test::algorithms::merge_join_galloping(1000000);
+
+    // a multiway merge sort of enough large elements for blocks merged in two passes,
+    // timed against merge_sort and std::stable_sort
+    cdmh::test::algorithms::multiway_merge_sort_timed(70000);
+
+    // counting sort of values from a small range in containers of each type
+    cdmh::test::algorithms::counting_sorts(counters);
+
+    // normalised keys order as the values they encode, in either direction
+    cdmh::test::algorithms::normalized_key_encoding();
+
+    // rows sorted by (tenant asc, time desc, name asc, score desc nulls last) with
+    // normalised keys, and by their prefixes and a comparator, against std::stable_sort
+    cdmh::test::algorithms::normalized_key_sort(10000);
+
+    // a sorted range with a few, then many, elements modified, sorted again in place
+    // and by merging, against a stable sort
+    cdmh::test::algorithms::resort_dirty(10000);
+
+    // a cooperative sort in slices of a millisecond, against the blocking introsort
+    cdmh::test::algorithms::sort_task_timed(std::vector<int>(1000000));
+
+#if defined(__unix__) || defined(__APPLE__)
+    // sort files of binary records in place through a memory map
+    cdmh::test::algorithms::record_sort<16>(0);
+    cdmh::test::algorithms::record_sort<16>(1000);
+    cdmh::test::algorithms::record_sort<12>(1000);
+
+    // sample sort calls to a file, as replayed by sort_replay
+    cdmh::test::algorithms::sort_sampler();
+
+    // trace the spans of recursive and parallel sorts, for a trace viewer
+    cdmh::test::algorithms::sort_trace();
+#endif
 
-    run_exhaustive_tests();
+    run_exhaustive_tests(counters);
 }
 
 // Permission is hereby granted, free of charge, to any person obtaining a copy
@@ -0,0 +1,140 @@
+﻿// Copyright (c) 2013 Craig Henderson
+// https://github.com/cdmh/sorting_algorithms
+
+#pragma once
+
+#include "sort.h"
+#include "heap_sort.h"
+#include "nth_element.h"
+#include <vector>
+
+namespace cdmh {
+
+// Top-k Accumulator
+//     push                         O(1) amortised, O(log k) while filling
+//     extract_sorted               O(k log k)
+//     Space complexity             O(k)
+//
+// keeps the first k elements in the order from a stream of pushed elements. the
+// retained elements are held in a heap with the last of them, the cutoff, at the
+// top, so an element that does not come before the cutoff is rejected with a single
+// comparison. elements that do are appended to a buffer of up to k candidates
+// rather than inserted into the heap; when the buffer is full the best k of the heap
+// and the buffer are selected with nth_element and the heap is rebuilt, tightening
+// the cutoff. an accumulator is not thread safe; give each producer thread its own
+// and combine them with merge()
+
+template<typename T, typename Pred=std::less<T>>
+class topk_accumulator
+{
+  public:
+    explicit topk_accumulator(size_t k, Pred pred=Pred())
+      : capacity_(k),
+        pred_(pred)
+    {
+        values_.reserve(2 * capacity_);
+    }
+
+    void push(T const &value)
+    {
+        if (values_.size() < capacity_)
+        {
+            values_.push_back(value);
+            std::push_heap(values_.begin(), values_.end(), pred_);
+        }
+        else if (capacity_ > 0  &&  pred_(value, values_.front()))
+        {
+            values_.push_back(value);
+            if (values_.size() == 2 * capacity_)
+                compact();
+        }
+    }
+
+    template<typename It>
+    void push(It begin, It end)
+    {
+        for (; begin!=end; ++begin)
+            push(*begin);
+    }
+
+    // push the elements retained by another accumulator, or by this one a second time
+    void merge(topk_accumulator const &other)
+    {
+        if (&other == this)
+        {
+            // pushing may reallocate the elements being pushed
+            std::vector<T> const values(values_);
+            push(values.begin(), values.end());
+        }
+        else
+            push(other.values_.begin(), other.values_.end());
+    }
+
+    // the retained elements in order, leaving the accumulator empty
+    std::vector<T> extract_sorted()
+    {
+        select();
+        cdmh::heap_sort(values_.begin(), values_.end(), pred_);
+
+        std::vector<T> result;
+        result.reserve(2 * capacity_);
+        result.swap(values_);
+        return result;
+    }
+
+    size_t size() const
+    {
+        return std::min(values_.size(), capacity_);
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    void clear()
+    {
+        values_.clear();
+    }
+
+  private:
+    // discard all but the best k elements of the heap and the buffer
+    void select()
+    {
+        if (values_.size() > capacity_)
+        {
+            cdmh::nth_element(values_.begin(), values_.begin() + capacity_, values_.end(), pred_);
+            values_.erase(values_.begin() + capacity_, values_.end());
+        }
+    }
+
+    void compact()
+    {
+        select();
+        std::make_heap(values_.begin(), values_.end(), pred_);
+    }
+
+    size_t         capacity_;
+    Pred           pred_;
+    std::vector<T> values_;     // heap of [0, k), followed by the candidate buffer
+};
+
+}   // namespace cdmh
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.